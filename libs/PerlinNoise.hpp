@@ -33,6 +33,7 @@
 # include <numeric>
 # include <random>
 # include <type_traits>
+# include <utility>
 
 # if __has_include(<concepts>) && defined(__cpp_concepts)
 #	include <concepts>
@@ -236,6 +237,20 @@ namespace siv
 		[[nodiscard]]
 		value_type normalizedOctave3D_01(value_type x, value_type y, value_type z, std::int32_t octaves, value_type persistence = value_type(0.5)) const noexcept;
 
+		///////////////////////////////////////
+		//
+		//	Octave noise with the octave count fixed at compile time and persistence 0.5
+		//	The loop is unrolled and the amplitudes are constants, results match the functions above exactly
+		//
+
+		template <std::int32_t Octaves>
+		[[nodiscard]]
+		value_type unrolledOctave2D_01(value_type x, value_type y) const noexcept;
+
+		template <std::int32_t Octaves>
+		[[nodiscard]]
+		value_type unrolledNormalizedOctave2D_01(value_type x, value_type y) const noexcept;
+
 	private:
 
 		state_type m_permutation;
@@ -403,6 +418,32 @@ namespace siv
 
 			return result;
 		}
+
+		template <class Float, std::int32_t Octaves>
+		inline constexpr Float UnrolledMaxAmplitude = MaxAmplitude(Octaves, Float(0.5));
+
+		template <class Noise, class Float, std::size_t... Octave>
+		[[nodiscard]]
+		inline auto UnrolledOctave2D(const Noise& noise, const Float x, const Float y, std::index_sequence<Octave...>) noexcept
+		{
+			using value_type = Float;
+
+			// Powers of two, so x * frequency is exactly the repeated doubling of the loop above
+			constexpr value_type frequencies[] = { value_type(std::uint64_t(1) << Octave)... };
+			constexpr value_type amplitudes[] = { (value_type(1) / value_type(std::uint64_t(1) << Octave))... };
+
+			value_type result = 0;
+			((result += (noise.noise2D(x * frequencies[Octave], y * frequencies[Octave]) * amplitudes[Octave])), ...);
+			return result;
+		}
+
+		template <std::int32_t Octaves, class Noise, class Float>
+		[[nodiscard]]
+		inline auto UnrolledOctave2D(const Noise& noise, const Float x, const Float y) noexcept
+		{
+			static_assert(0 < Octaves && Octaves < 64);
+			return UnrolledOctave2D(noise, x, y, std::make_index_sequence<Octaves>{});
+		}
 	}
 
 	///////////////////////////////////////
@@ -652,6 +693,22 @@ namespace siv
 	{
 		return perlin_detail::Remap_01(normalizedOctave3D(x, y, z, octaves, persistence));
 	}
+
+	///////////////////////////////////////
+
+	template <class Float>
+	template <std::int32_t Octaves>
+	inline typename BasicPerlinNoise<Float>::value_type BasicPerlinNoise<Float>::unrolledOctave2D_01(const value_type x, const value_type y) const noexcept
+	{
+		return perlin_detail::RemapClamp_01(perlin_detail::UnrolledOctave2D<Octaves>(*this, x, y));
+	}
+
+	template <class Float>
+	template <std::int32_t Octaves>
+	inline typename BasicPerlinNoise<Float>::value_type BasicPerlinNoise<Float>::unrolledNormalizedOctave2D_01(const value_type x, const value_type y) const noexcept
+	{
+		return perlin_detail::Remap_01(perlin_detail::UnrolledOctave2D<Octaves>(*this, x, y) / perlin_detail::UnrolledMaxAmplitude<Float, Octaves>);
+	}
 }
 
 # undef SIVPERLIN_NODISCARD_CXX20
@@ -0,0 +1,87 @@
+import argparse
+import json
+import pathlib
+
+from shapely.geometry import box, shape
+from shapely.ops import unary_union
+
+# Cuts the country borders of a GeoJSON file into a z/x/y pyramid for VectorTileCache.
+# Borders are merged into one noded line set first, so a border shared by two countries
+# is stored once and simplifies the same way for both. Tiles hold lines, not polygons,
+# so clipping never adds edges along tile seams.
+# Tile (z, x, y) covers 1 / 2^z of the data bounds on each axis, x grows east, y grows north.
+#
+#   python scripts/geo/tile.py countries.geo.json res/tiles/vector --max-zoom 5
+
+
+def outer_rings(geometry):
+    polygons = [geometry] if geometry.geom_type == "Polygon" else list(geometry.geoms)
+    # Outer rings only, like MapRenderer
+    return [polygon.exterior for polygon in polygons]
+
+
+def flatten(lines):
+    if lines.is_empty:
+        return []
+    parts = [lines] if lines.geom_type == "LineString" else [g for g in getattr(lines, "geoms", []) if g.geom_type == "LineString"]
+    result = []
+    for part in parts:
+        coords = [round(value, 6) for point in part.coords for value in point[:2]]
+        if len(coords) >= 4:
+            result.append(coords)
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Build a vector tile pyramid from GeoJSON borders")
+    parser.add_argument("input", help="GeoJSON FeatureCollection")
+    parser.add_argument("output", help="Output directory")
+    parser.add_argument("--max-zoom", type=int, default=5)
+    parser.add_argument("--tile-pixels", type=int, default=512, help="Tile size the simplification tolerance is tuned for")
+    args = parser.parse_args()
+
+    with open(args.input, "r") as file:
+        data = json.load(file)
+
+    rings = []
+    for feature in data["features"]:
+        geometry = shape(feature["geometry"])
+        if geometry.geom_type in ("Polygon", "MultiPolygon"):
+            rings.extend(outer_rings(geometry))
+
+    borders = unary_union(rings)
+    min_x, min_y, max_x, max_y = borders.bounds
+
+    output = pathlib.Path(args.output)
+    tile_count = 0
+    for z in range(args.max_zoom + 1):
+        tiles = 2 ** z
+        width = (max_x - min_x) / tiles
+        height = (max_y - min_y) / tiles
+        # Half a pixel of the tile at its intended size
+        tolerance = max(width, height) / args.tile_pixels / 2
+
+        for x in range(tiles):
+            for y in range(tiles):
+                tile_box = box(min_x + x * width, min_y + y * height, min_x + (x + 1) * width, min_y + (y + 1) * height)
+                if not borders.intersects(tile_box):
+                    continue
+                lines = flatten(borders.intersection(tile_box).simplify(tolerance, preserve_topology=False))
+                if not lines:
+                    continue
+
+                tile_path = output / str(z) / str(x) / f"{y}.json"
+                tile_path.parent.mkdir(parents=True, exist_ok=True)
+                with open(tile_path, "w") as file:
+                    json.dump({"lines": lines}, file, separators=(",", ":"))
+                tile_count += 1
+
+        print(f"zoom {z}: {tiles}x{tiles} grid, tolerance {tolerance:.6f}")
+
+    with open(output / "meta.json", "w") as file:
+        json.dump({"bounds": [min_x, min_y, max_x, max_y], "maxZoom": args.max_zoom}, file)
+    print(f"Wrote {tile_count} tiles to {output}")
+
+
+if __name__ == "__main__":
+    main()
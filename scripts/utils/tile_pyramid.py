@@ -0,0 +1,54 @@
+import argparse
+import json
+import math
+import pathlib
+
+from PIL import Image
+
+Image.MAX_IMAGE_PIXELS = None  # The Earth imagery is far above PIL's decompression bomb limit
+
+# Cuts an image into a mip pyramid of fixed-size PNG tiles for TextureTileCache.
+# Level maxLevel is the full resolution, every level below halves it, level 0 fits one tile.
+# Tiles are named <level>/<x>/<y>.png, x to the right and y down, edge tiles are cropped.
+#
+#   python scripts/utils/tile_pyramid.py res/Earth-Large.png res/tiles/earth --tile-size 512
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Build a texture tile pyramid from an image")
+    parser.add_argument("input", help="Source image")
+    parser.add_argument("output", help="Output directory")
+    parser.add_argument("--tile-size", type=int, default=512)
+    args = parser.parse_args()
+
+    image = Image.open(args.input).convert("RGBA")
+    width, height = image.size
+    tile_size = args.tile_size
+    max_level = max(0, math.ceil(math.log2(max(width, height) / tile_size)))
+
+    output = pathlib.Path(args.output)
+    tile_count = 0
+    level_image = image
+    for level in range(max_level, -1, -1):
+        level_width, level_height = level_image.size
+        columns = math.ceil(level_width / tile_size)
+        rows = math.ceil(level_height / tile_size)
+        for x in range(columns):
+            for y in range(rows):
+                box = (x * tile_size, y * tile_size, min((x + 1) * tile_size, level_width), min((y + 1) * tile_size, level_height))
+                tile_path = output / str(level) / str(x) / f"{y}.png"
+                tile_path.parent.mkdir(parents=True, exist_ok=True)
+                level_image.crop(box).save(tile_path)
+                tile_count += 1
+        print(f"level {level}: {level_width}x{level_height}, {columns}x{rows} tiles")
+
+        # Each level is filtered down from the one above, not from the source, to keep it cheap
+        level_image = level_image.resize((max(1, math.ceil(level_width / 2)), max(1, math.ceil(level_height / 2))), Image.LANCZOS)
+
+    with open(output / "meta.json", "w") as file:
+        json.dump({"width": width, "height": height, "tileSize": tile_size, "maxLevel": max_level}, file)
+    print(f"Wrote {tile_count} tiles to {output}")
+
+
+if __name__ == "__main__":
+    main()
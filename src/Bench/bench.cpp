@@ -0,0 +1,67 @@
+#include "bench.hpp"
+#include <cmath>
+#include <iostream>
+#include <map>
+#include "../Map/gen.hpp"
+#include "../Utils/frame_stats.hpp"
+
+int runBenchmark(const std::string& name) {
+    const std::map<std::string, int (*)()> benchmarks = {
+        {"biomes", benchBiomes},
+        {"contours", benchContours},
+        {"cubes", benchCubes},
+        {"noise-regen", benchNoiseRegen},
+        {"octaves", benchOctaves},
+        {"pan-zoom", benchPanZoom},
+        {"texture-startup", benchTextureStartup},
+        {"warp", benchWarp},
+    };
+
+    auto it = benchmarks.find(name);
+    if (it == benchmarks.end()) {
+        std::cerr << "Unknown benchmark: " << name << "\nAvailable benchmarks:" << std::endl;
+        for (const auto& benchmark : benchmarks) {
+            std::cerr << "  " << benchmark.first << std::endl;
+        }
+        return 1;
+    }
+    return it->second();
+}
+
+sf::View benchFlightView(int frame, int frameCount) {
+    const float t = static_cast<float>(frame) / frameCount;
+    const float zoom = std::pow(8.0f, std::sin(t * 3.14159265f));
+    const float angle = t * 2.0f * 3.14159265f * 3.0f;
+
+    sf::View view;
+    view.setSize(1920.0f / zoom, 1080.0f / zoom);
+    view.setCenter(960.0f + std::cos(angle) * 600.0f * (1.0f - 1.0f / zoom),
+                   540.0f + std::sin(angle) * 300.0f * (1.0f - 1.0f / zoom));
+    return view;
+}
+
+BenchGrid makeBenchGrid() {
+    return BenchGrid(BENCH_GRID_WIDTH, std::vector<double>(BENCH_GRID_HEIGHT));
+}
+
+bool reportComparison(const std::string& title, bool identical, const FrameStats& baseline, const FrameStats& candidate) {
+    std::cout << title << ", " << BENCH_GRID_WIDTH << "x" << BENCH_GRID_HEIGHT << ", " << (identical ? "identical" : "DIFFERENT")
+              << ", " << baseline.getMeanMs() / candidate.getMeanMs() << "x" << std::endl;
+    baseline.print(std::cout);
+    candidate.print(std::cout);
+    return identical;
+}
+
+FrameStats timeRegeneration(const LandmassSettings& settings, int runs, const char* label) {
+    LandmassGenerator generator(settings);
+    FrameStats regen(label);
+    for (int run = 0; run < runs; run++) {
+        // Every run changes the frequency, so each update() regenerates everything
+        generator.settings.octaveMultiplierX = settings.octaveMultiplierX + (run % 2 == 0 ? 0.001f : 0.0f);
+        sf::Clock clock;
+        generator.update();
+        regen.addSample(clock.getElapsedTime());
+    }
+    regen.print(std::cout);
+    return regen;
+}
@@ -0,0 +1,74 @@
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
+
+class FrameStats;
+struct LandmassSettings;
+
+struct HeadlessSettings {
+    int frameCount = 600;
+    int dumpEvery = 100;                     // write every Nth frame as PNG, 0 for none
+    std::string outputDirectory = "headless";
+    unsigned width = 1920;
+    unsigned height = 1080;
+};
+
+// Runs a named benchmark (`main --bench <name>`) and returns the process exit code
+int runBenchmark(const std::string& name);
+
+// The debug scene rendered offscreen along the benchmark flight path (`main --headless`),
+// per-frame CPU times go to <output>/frames.csv
+int runHeadless(const HeadlessSettings& settings);
+
+// Plays a flight recorded with CameraRecording against the debug scene (`main --replay <file>`)
+// and reports frame time percentiles per stage
+int runReplay(const std::string& path);
+
+// Zoom from 1x to 8x and back while circling a 1920x1080 scene, the same path for every pass
+sf::View benchFlightView(int frame, int frameCount);
+
+// The terrain heightfield's size and default noise frequency, for the noise benchmarks
+constexpr std::size_t BENCH_GRID_WIDTH = 1920 / 5;
+constexpr std::size_t BENCH_GRID_HEIGHT = 1080 / 5;
+constexpr float BENCH_NOISE_FREQUENCY = 0.06f;
+using BenchGrid = std::vector<std::vector<double>>;
+
+// A zeroed BENCH_GRID_WIDTH x BENCH_GRID_HEIGHT grid, indexed [x][y]
+BenchGrid makeBenchGrid();
+
+// Prints "<title>, <width>x<height>, identical|DIFFERENT, <speedup>x" for the grid and both timings,
+// returns identical so a benchmark fails when its fast path drifts
+bool reportComparison(const std::string& title, bool identical, const FrameStats& baseline, const FrameStats& candidate);
+
+// Times runs full regenerations of a generator built with settings, the way a slider change triggers
+// them, and prints the timings under label
+FrameStats timeRegeneration(const LandmassSettings& settings, int runs, const char* label);
+
+// Scripted pan and zoom over the country borders, with and without view culling
+int benchPanZoom();
+
+// Frame times of the contour layer, batched mesh against per-contour strips
+int benchContours();
+
+// Cold texture load, PNG decode and upload against the mapped raw pixel cache
+int benchTextureStartup();
+
+// Terrain cube mesh size, rebuild and draw times, sf::Vertex quads against GPU instancing
+int benchCubes();
+
+// Terrain noise fill time per octave count, the runtime octave loop against the unrolled kernels
+int benchOctaves();
+
+// Permutation setup, heightfield fill and full regeneration times, fresh noise per seed against the noise cache
+int benchNoiseRegen();
+
+// Height, moisture and temperature noise as three passes against one fused pass, and regeneration with biomes
+int benchBiomes();
+
+// Domain-warped heightfield as three passes through offset grids against the fused tiled kernel, with throughput
+int benchWarp();
+
+#endif // BENCH_HPP
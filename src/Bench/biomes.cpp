@@ -0,0 +1,59 @@
+#include "bench.hpp"
+#include <iostream>
+#include "../Map/fused_noise.hpp"
+#include "../Map/gen.hpp"
+#include "../Utils/frame_stats.hpp"
+
+int benchBiomes() {
+    const int runs = 10;
+    const NoiseState::seed_type seed = LandmassSettings().seedValue;
+    const int heightOctaves = LandmassSettings().octaves;
+
+    const std::array<std::shared_ptr<const NoiseState>, 3> states = {
+        NoiseCache::global().get(seed),
+        NoiseCache::global().get(deriveNoiseSeed(seed, NoiseChannel::Moisture)),
+        NoiseCache::global().get(deriveNoiseSeed(seed, NoiseChannel::Temperature)),
+    };
+    const FusedNoise<3> fused(states);
+    bool identical = true;
+
+    // Height, moisture and temperature on one thread: a pass per channel with the unrolled kernels
+    // against the fused pass, with the climate channels at full and at biome octaves
+    for (const std::array<int, 3>& octaves : {std::array<int, 3>{heightOctaves, heightOctaves, heightOctaves},
+                                              std::array<int, 3>{heightOctaves, 6, 6}}) {
+        BenchGrid separate[3] = {makeBenchGrid(), makeBenchGrid(), makeBenchGrid()};
+        BenchGrid combined[3] = {makeBenchGrid(), makeBenchGrid(), makeBenchGrid()};
+
+        FrameStats separateStats("3 passes");
+        FrameStats fusedStats("fused");
+        for (int run = 0; run < runs; run++) {
+            sf::Clock clock;
+            for (int channel = 0; channel < 3; channel++) {
+                selectNoiseKernel(octaves[channel])(*states[channel], BENCH_NOISE_FREQUENCY, BENCH_NOISE_FREQUENCY, octaves[channel],
+                    separate[channel], 0, BENCH_GRID_WIDTH);
+            }
+            separateStats.addSample(clock.restart());
+            for (std::size_t x = 0; x < BENCH_GRID_WIDTH; ++x) {
+                for (std::size_t y = 0; y < BENCH_GRID_HEIGHT; ++y) {
+                    const FusedNoise<3>::Sample sample = fused.octave2D_01(x * BENCH_NOISE_FREQUENCY, y * BENCH_NOISE_FREQUENCY, octaves);
+                    for (int channel = 0; channel < 3; channel++) {
+                        combined[channel][x][y] = sample[channel];
+                    }
+                }
+            }
+            fusedStats.addSample(clock.getElapsedTime());
+        }
+
+        const std::string title = "biomes: " + std::to_string(octaves[0]) + "/" + std::to_string(octaves[1]) + "/"
+            + std::to_string(octaves[2]) + " octaves";
+        const bool same = separate[0] == combined[0] && separate[1] == combined[1] && separate[2] == combined[2];
+        identical = reportComparison(title, same, separateStats, fusedStats) && identical;
+    }
+
+    // The whole regeneration with and without the biome stage
+    LandmassSettings settings;
+    timeRegeneration(settings, runs, "regen without biomes");
+    settings.drawBiomes = true;
+    timeRegeneration(settings, runs, "regen with biomes");
+    return identical ? 0 : 1;
+}
@@ -0,0 +1,75 @@
+#include "bench.hpp"
+#include <iostream>
+#include "../Map/contours.hpp"
+#include "../Utils/frame_stats.hpp"
+#include "../Utils/progressbar.hpp"
+
+namespace {
+
+// The previous per-frame path: one strip per contour, rebuilt and scaled on the CPU every frame
+void drawContourStrips(sf::RenderTarget& target, const ContourStore& contours, const sf::Transform& transform) {
+    for (std::size_t c = 0; c < contours.getContourCount(); c++) {
+        const ContourView contour = contours.getContour(c);
+        sf::VertexArray lineStrip(sf::PrimitiveType::LineStrip, contour.getPointCount());
+        for (size_t i = 0; i + 1 < contour.size; i += 2) {
+            lineStrip[i / 2].position = transform.transformPoint(contour[i], contour[i + 1]);
+            lineStrip[i / 2].color = sf::Color::Green;
+        }
+        target.draw(lineStrip);
+    }
+}
+
+} // namespace
+
+int benchContours() {
+    const int frameCount = 600;
+
+    sf::RenderWindow window(sf::VideoMode(1920, 1080), "Fortifier: contours benchmark");
+    window.setVisible(false);
+    ProgressBar progressBar(window, sf::Vector2f(1920, 20), sf::Vector2f(0, 1080 - 20), sf::Color::Green, sf::Color::White);
+    progressBar.setTotalItems(1);
+
+    sf::RenderTexture target;
+    if (!target.create(1920, 1080)) {
+        std::cerr << "Failed to create render texture" << std::endl;
+        return 1;
+    }
+
+    Contours contours("./contours.json");
+    sf::Clock loadClock;
+    contours.asyncLoadContours(progressBar);
+    while (!contours.update()) {
+        if (contours.hasFailed()) {
+            return 1;
+        }
+        sf::sleep(sf::milliseconds(1));
+    }
+    const ContourStore& source = contours.getContours();
+
+    std::cout << "contours: " << source.getContourCount() << " contours, " << contours.getSegmentCount() << " segments, "
+              << frameCount << " frames per pass, loaded in "
+              << loadClock.getElapsedTime().asMilliseconds() << " ms (" << source.getMemoryUsage() / 1024 << " KB)" << std::endl;
+
+    FrameStats strips("per-contour strips");
+    FrameStats batched("batched mesh");
+    for (int frame = 0; frame < frameCount; frame++) {
+        const sf::View view = benchFlightView(frame, frameCount);
+        target.setView(view);
+
+        sf::Clock clock;
+        target.clear(sf::Color::Black);
+        contours.draw(target, 1.0f);
+        target.display();
+        batched.addSample(clock.getElapsedTime());
+
+        clock.restart();
+        target.clear(sf::Color::Black);
+        drawContourStrips(target, source, contours.getTransform(target.getSize(), 1.0f));
+        target.display();
+        strips.addSample(clock.getElapsedTime());
+    }
+
+    strips.print(std::cout);
+    batched.print(std::cout);
+    return 0;
+}
@@ -0,0 +1,63 @@
+#include "bench.hpp"
+#include <iostream>
+#include "../Map/gen.hpp"
+#include "../Utils/frame_stats.hpp"
+#include "../Utils/memory_registry.hpp"
+
+int benchCubes() {
+    const int rebuildCount = 50;
+    const int frameCount = 300;
+
+    sf::RenderTexture target;
+    if (!target.create(1920, 1080)) {
+        std::cerr << "Failed to create render texture" << std::endl;
+        return 1;
+    }
+
+    struct Pass {
+        const char* name;
+        bool instanced;
+    };
+    const Pass passes[] = {
+        {"vertex array", false},
+        {"instanced", true},
+    };
+
+    for (const Pass& pass : passes) {
+        LandmassSettings settings;
+        settings.instancedCubes = pass.instanced;
+        LandmassGenerator generator(settings);
+
+        // The first draw sets up GL, and falls back to the vertex array if instancing is unavailable
+        target.clear(sf::Color::Black);
+        generator.draw(target);
+        target.display();
+
+        // Nudging the height is a shader uniform on both paths, this only costs mesh work when it is baked
+        FrameStats rebuildStats(std::string(pass.name) + " rebuild");
+        for (int i = 0; i < rebuildCount; i++) {
+            generator.settings.cubeHeightMultiplier = settings.cubeHeightMultiplier + (i % 2 == 0 ? 0.01f : 0.0f);
+            sf::Clock clock;
+            generator.update();
+            rebuildStats.addSample(clock.getElapsedTime());
+        }
+
+        FrameStats drawStats(std::string(pass.name) + " draw");
+        for (int frame = 0; frame < frameCount; frame++) {
+            target.setView(benchFlightView(frame, frameCount));
+            sf::Clock clock;
+            target.clear(sf::Color::Black);
+            generator.draw(target);
+            target.display();
+            drawStats.addSample(clock.getElapsedTime());
+        }
+
+        MemoryRegistry registry;
+        generator.reportMemory(registry);
+        const std::size_t meshBytes = registry.getUsage("terrain.vertices").bytes + registry.getUsage("terrain.instances").bytes;
+        std::cout << "cubes: " << pass.name << ", mesh " << meshBytes / 1024.0 << " KB" << std::endl;
+        rebuildStats.print(std::cout);
+        drawStats.print(std::cout);
+    }
+    return 0;
+}
@@ -0,0 +1,94 @@
+#include "bench.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include "../Map/gen.hpp"
+#include "../Map/map_texture.hpp"
+#include "../Map/renderer.hpp"
+#include "../Utils/frame_arena.hpp"
+#include "../Utils/frame_stats.hpp"
+#include "../Utils/progressbar.hpp"
+
+int runHeadless(const HeadlessSettings& settings) {
+#ifndef _WIN32
+    // Mesa's software rasteriser, so runs do not depend on the GPU or driver of the machine.
+    // SFML still opens its GL context through X, on a box without a display run under xvfb-run
+    setenv("LIBGL_ALWAYS_SOFTWARE", "1", 0);
+#endif
+
+    std::error_code error;
+    std::filesystem::create_directories(settings.outputDirectory, error);
+    if (error) {
+        std::cerr << "Failed to create " << settings.outputDirectory << ": " << error.message() << std::endl;
+        return 1;
+    }
+
+    sf::RenderTexture target;
+    if (!target.create(settings.width, settings.height)) {
+        std::cerr << "Failed to create render texture" << std::endl;
+        return 1;
+    }
+    const sf::Vector2u targetSize = target.getSize();
+
+    // Never opened, the progress bar only keeps a reference to it
+    sf::RenderWindow window;
+    ProgressBar progressBar(window, sf::Vector2f(1920, 20), sf::Vector2f(0, 1080 - 20), sf::Color::Green, sf::Color::White);
+    progressBar.setTotalItems(3);
+
+    // The debug scene: Earth texture, terrain, borders and names
+    MapRenderer mapRenderer("./countries.geo.json", progressBar);
+    mapRenderer.setVectorTiles("res/tiles/vector");
+    mapRenderer.toggleNames = true;
+    RendererSettings rendererSettings = {sf::Vector2f(0.0, 0.0), sf::Vector2f(0.0, 0.0)};
+
+    LandmassSettings landmassSettings;
+    LandmassGenerator landmassGenerator(landmassSettings);
+
+    MapDrawTexture mapDrawTexture(progressBar);
+    mapDrawTexture.loadTexturesAsync();
+    sf::Clock loadClock;
+    while (!progressBar.isComplete()) {
+        mapDrawTexture.updateMapTexture(1.0f, targetSize);
+        sf::sleep(sf::milliseconds(1));
+    }
+
+    std::cout << "headless: " << settings.frameCount << " frames at " << targetSize.x << "x" << targetSize.y
+              << ", loaded in " << loadClock.getElapsedTime().asMilliseconds() << " ms, output in "
+              << settings.outputDirectory << std::endl;
+
+    std::ofstream frameLog(settings.outputDirectory + "/frames.csv");
+    frameLog << "frame,cpu_ms\n";
+
+    FrameStats stats("headless frame");
+    for (int frame = 0; frame < settings.frameCount; frame++) {
+        target.setView(benchFlightView(frame, settings.frameCount));
+
+        sf::Clock clock;
+        target.clear(sf::Color::Black);
+        mapDrawTexture.updateMapTexture(1.0f, targetSize);
+        mapDrawTexture.draw(target);
+        landmassGenerator.draw(target);
+        mapRenderer.draw(target, 1.0f, rendererSettings, sf::Vector2u(0, 0));
+        target.display();
+        FrameArena::get().reset();
+        const sf::Time elapsed = clock.getElapsedTime();
+
+        stats.addSample(elapsed);
+        frameLog << frame << ',' << elapsed.asMicroseconds() / 1000.0 << '\n';
+
+        // Read back outside the timed section, it waits for the GPU
+        if (settings.dumpEvery > 0 && frame % settings.dumpEvery == 0) {
+            char name[32];
+            std::snprintf(name, sizeof(name), "/frame_%05d.png", frame);
+            if (!target.getTexture().copyToImage().saveToFile(settings.outputDirectory + name)) {
+                std::cerr << "Failed to write frame " << frame << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    stats.print(std::cout);
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include "bench.hpp"
+#include <iostream>
+#include "../Map/gen.hpp"
+#include "../Utils/frame_stats.hpp"
+#include "../Utils/thread_pool.hpp"
+
+int benchNoiseRegen() {
+    const int octaves = LandmassSettings().octaves;
+    const NoiseState::seed_type seed = LandmassSettings().seedValue;
+    const int setupRuns = 1000;
+    const int fillRuns = 20;
+    const int regenRuns = 20;
+
+    // Getting a permutation table: seeding and shuffling every time against a warm cache
+    FrameStats freshSetup("fresh PerlinNoise(seed)");
+    FrameStats cachedSetup("cached NoiseState");
+    NoiseCache cache;
+    cache.get(seed);
+    for (int run = 0; run < setupRuns; run++) {
+        sf::Clock clock;
+        const siv::PerlinNoise perlin(seed);
+        freshSetup.addSample(clock.restart());
+        const std::shared_ptr<const NoiseState> noise = cache.get(seed);
+        cachedSetup.addSample(clock.getElapsedTime());
+    }
+    std::cout << "noise-regen: permutation setup, " << setupRuns << " runs" << std::endl;
+    freshSetup.print(std::cout);
+    cachedSetup.print(std::cout);
+
+    // Filling the heightfield on the pool with the same octave loop: the library's noise against the cached state's
+    // doubled table and gradient lookup
+    BenchGrid libraryGrid = makeBenchGrid();
+    BenchGrid stateGrid = makeBenchGrid();
+    const siv::PerlinNoise perlin(seed);
+    const std::shared_ptr<const NoiseState> noise = cache.get(seed);
+    FrameStats libraryFill("siv::PerlinNoise fill");
+    FrameStats stateFill("NoiseState fill");
+    for (int run = 0; run < fillRuns; run++) {
+        sf::Clock clock;
+        ThreadPool::global().parallelFor(0, BENCH_GRID_WIDTH, 8, [&](std::size_t first, std::size_t last) {
+            for (std::size_t x = first; x < last; ++x) {
+                for (std::size_t y = 0; y < BENCH_GRID_HEIGHT; ++y) {
+                    libraryGrid[x][y] = perlin.octave2D_01(x * BENCH_NOISE_FREQUENCY, y * BENCH_NOISE_FREQUENCY, octaves);
+                }
+            }
+        });
+        libraryFill.addSample(clock.restart());
+        ThreadPool::global().parallelFor(0, BENCH_GRID_WIDTH, 8, [&](std::size_t first, std::size_t last) {
+            fillNoiseColumns(*noise, BENCH_NOISE_FREQUENCY, BENCH_NOISE_FREQUENCY, octaves, stateGrid, first, last);
+        });
+        stateFill.addSample(clock.getElapsedTime());
+    }
+    const bool identical = reportComparison("noise-regen: " + std::to_string(octaves) + " octave fill", libraryGrid == stateGrid,
+                                            libraryFill, stateFill);
+
+    // The whole regeneration a settings change triggers, heightfield, mesh and isolines
+    std::cout << "noise-regen: settings change to next frame, " << regenRuns << " runs" << std::endl;
+    timeRegeneration(LandmassSettings(), regenRuns, "regen");
+    return identical ? 0 : 1;
+}
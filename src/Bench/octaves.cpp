@@ -0,0 +1,31 @@
+#include "bench.hpp"
+#include <iostream>
+#include "../Map/terrain_noise.hpp"
+#include "../Utils/frame_stats.hpp"
+
+int benchOctaves() {
+    // Filled on one thread so only the kernel is timed
+    const int runs = 20;
+    const NoiseState noise(97088);
+
+    for (int octaves : {1, 2, 4, 8, 12, 16, MAX_UNROLLED_OCTAVES}) {
+        BenchGrid looped = makeBenchGrid();
+        BenchGrid unrolled = makeBenchGrid();
+        const NoiseColumnKernel kernel = selectNoiseKernel(octaves);
+
+        FrameStats loopStats("loop");
+        FrameStats unrolledStats("unrolled");
+        for (int run = 0; run < runs; run++) {
+            sf::Clock clock;
+            fillNoiseColumns(noise, BENCH_NOISE_FREQUENCY, BENCH_NOISE_FREQUENCY, octaves, looped, 0, BENCH_GRID_WIDTH);
+            loopStats.addSample(clock.restart());
+            kernel(noise, BENCH_NOISE_FREQUENCY, BENCH_NOISE_FREQUENCY, octaves, unrolled, 0, BENCH_GRID_WIDTH);
+            unrolledStats.addSample(clock.getElapsedTime());
+        }
+
+        if (!reportComparison("octaves: " + std::to_string(octaves), looped == unrolled, loopStats, unrolledStats)) {
+            return 1;
+        }
+    }
+    return 0;
+}
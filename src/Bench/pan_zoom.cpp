@@ -0,0 +1,82 @@
+#include "bench.hpp"
+#include <iostream>
+#include "../Map/renderer.hpp"
+#include "../Utils/allocation_counter.hpp"
+#include "../Utils/frame_arena.hpp"
+#include "../Utils/frame_stats.hpp"
+#include "../Utils/progressbar.hpp"
+
+int benchPanZoom() {
+    const int frameCount = 600;
+
+    sf::RenderWindow window(sf::VideoMode(1920, 1080), "Fortifier: pan/zoom benchmark");
+    window.setVisible(false);
+    ProgressBar progressBar(window, sf::Vector2f(1920, 20), sf::Vector2f(0, 1080 - 20), sf::Color::Green, sf::Color::White);
+
+    sf::RenderTexture target;
+    if (!target.create(1920, 1080)) {
+        std::cerr << "Failed to create render texture" << std::endl;
+        return 1;
+    }
+
+    MapRenderer mapRenderer("./countries.geo.json", progressBar);
+    RendererSettings rendererSettings = {sf::Vector2f(0.0, 0.0), sf::Vector2f(0.0, 0.0)};
+
+    struct Pass {
+        const char* name;
+        bool cull;
+        bool names;
+        bool pan;   // move the map under a fixed view instead of moving the view
+    };
+    const Pass passes[] = {
+        {"borders, no culling", false, false, false},
+        {"borders, culled", true, false, false},
+        {"borders+names, culled", true, true, false},
+        {"borders+names, map panned", true, true, true},
+    };
+
+    std::cout << "pan/zoom: " << mapRenderer.getPolygonCount() << " polygons, " << frameCount << " frames per pass" << std::endl;
+    for (const Pass& pass : passes) {
+        mapRenderer.cullToView = pass.cull;
+        mapRenderer.toggleNames = pass.names;
+
+        FrameStats stats(pass.name);
+        FrameStats labelStats("label layout");
+        std::size_t visibleTotal = 0;
+        std::uint64_t steadyAllocations = 0;
+        sf::Clock clock;
+        AllocationCounter allocations;
+        for (int frame = 0; frame < frameCount; frame++) {
+            const sf::View view = benchFlightView(frame, frameCount);
+            if (pass.pan) {
+                // Same path, but the map transform's translation changes every frame
+                rendererSettings.offset = sf::Vector2f(960.0f, 540.0f) - view.getCenter();
+                target.setView(sf::View(sf::Vector2f(960.0f, 540.0f), view.getSize()));
+            } else {
+                rendererSettings.offset = sf::Vector2f(0.0f, 0.0f);
+                target.setView(view);
+            }
+            clock.restart();
+            allocations.reset();
+            target.clear(sf::Color::Black);
+            mapRenderer.draw(target, 1.0f, rendererSettings, sf::Vector2u(0, 0));
+            target.display();
+            // The first frame of a pass may still grow the arena and lay out labels
+            steadyAllocations += frame > 0 ? allocations.getCount() : 0;
+            FrameArena::get().reset();
+            stats.addSample(clock.getElapsedTime());
+            labelStats.addSample(mapRenderer.getLabelLayoutTime());
+            visibleTotal += mapRenderer.getVisiblePolygonCount();
+        }
+
+        stats.print(std::cout);
+        std::cout << "    average visible polygons: " << visibleTotal / frameCount << std::endl;
+        std::cout << "    heap allocations after the first frame: " << steadyAllocations << std::endl;
+        if (pass.names) {
+            labelStats.print(std::cout);
+            std::cout << "    label layout share of the frame: " << 100.0 * labelStats.getMeanMs() / stats.getMeanMs() << "%" << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,148 @@
+#include "bench.hpp"
+#include <iostream>
+#include <tuple>
+#include "../Camera/controller.hpp"
+#include "../Camera/recorder.hpp"
+#include "../Map/gen.hpp"
+#include "../Map/layer_compositor.hpp"
+#include "../Map/renderer.hpp"
+#include "../Utils/frame_arena.hpp"
+#include "../Utils/frame_stats.hpp"
+#include "../Utils/progressbar.hpp"
+
+int runReplay(const std::string& path) {
+    CameraRecording recording;
+    if (!recording.load(path)) {
+        return 1;
+    }
+
+    sf::RenderTexture target;
+    if (!target.create(1920, 1080)) {
+        std::cerr << "Failed to create render texture" << std::endl;
+        return 1;
+    }
+
+    // Never opened, the progress bar only keeps a reference to it
+    sf::RenderWindow window;
+    ProgressBar progressBar(window, sf::Vector2f(1920, 20), sf::Vector2f(0, 1080 - 20), sf::Color::Green, sf::Color::White);
+    progressBar.setTotalItems(1);
+
+    // The debug scene as main sets it up
+    sf::View view(sf::FloatRect(0, 0, 1920, 1080));
+    CameraController cameraController(view);
+    LandmassSettings landmassSettings;
+    LandmassGenerator landmassGenerator(landmassSettings);
+    MapRenderer mapRenderer("./countries.geo.json", progressBar);
+    mapRenderer.setVectorTiles("res/tiles/vector");
+    RendererSettings rendererSettings = {sf::Vector2f(0.0, 0.0), sf::Vector2f(0.0, 0.0)};
+    bool drawBorders = false;
+    float contourColor[3] = {0.f, 0.f, 0.f};
+    const auto borderState = [&]() {
+        // Everything that changes what the border layer draws
+        return std::make_tuple(mapRenderer.toggleNames, mapRenderer.cullToView, rendererSettings.scale, rendererSettings.offset,
+                               rendererSettings.fontSize, rendererSettings.fontColor[0], rendererSettings.fontColor[1],
+                               rendererSettings.fontColor[2]);
+    };
+
+    // The flight starts where the camera was when recording began
+    const CameraStart& start = recording.getStart();
+    cameraController.setState(start.center, start.size, start.zoomFactor);
+
+    // Layer renders are timed inside the compositor's callbacks, cached frames add nothing
+    sf::Time terrainTime;
+    sf::Time bordersTime;
+    LayerCompositor compositor;
+    const std::size_t terrainLayer = compositor.addLayer([&](sf::RenderTarget& layerTarget, const sf::Vector2u&) {
+        sf::Clock clock;
+        landmassGenerator.draw(layerTarget);
+        terrainTime += clock.getElapsedTime();
+    });
+    const std::size_t bordersLayer = compositor.addLayer([&](sf::RenderTarget& layerTarget, const sf::Vector2u& windowSize) {
+        sf::Clock clock;
+        mapRenderer.draw(layerTarget, 1.0f, rendererSettings, sf::Vector2u(0, 0), windowSize);
+        bordersTime += clock.getElapsedTime();
+    });
+
+    std::cout << "replay: " << path << ", " << recording.getFrameCount() << " frames, "
+              << recording.getEvents().size() << " events" << std::endl;
+
+    FrameStats frameStats("frame");
+    FrameStats inputStats("input + settings");
+    FrameStats updateStats("terrain update");
+    FrameStats terrainStats("terrain render");
+    FrameStats bordersStats("borders render");
+    FrameStats compositeStats("composite");
+    FrameStats displayStats("display");
+    std::size_t layerRenders = 0;
+
+    CameraReplay replay(recording);
+    while (true) {
+        sf::Clock frameClock;
+        sf::Clock stageClock;
+
+        const auto bordersBefore = borderState();
+        const bool playing = replay.step(cameraController, [&](const std::string& name, float value) {
+            // Colour channels are recorded as <name>R, <name>G and <name>B
+            const std::size_t channel = name.empty() ? std::string::npos : std::string("RGB").find(name.back());
+            const std::string colorName = channel == std::string::npos ? std::string() : name.substr(0, name.size() - 1);
+            if (name == "drawBorders") {
+                drawBorders = value != 0.0f;
+            } else if (name == "showNames") {
+                mapRenderer.toggleNames = value != 0.0f;
+            } else if (name == "fontSize") {
+                rendererSettings.fontSize = value;
+            } else if (colorName == "fontColor") {
+                rendererSettings.fontColor[channel] = value;
+            } else if (colorName == "mapColor") {
+                // Recorded with the rest of main's state, no layer draws with it yet
+            } else if (colorName == "contourColor") {
+                contourColor[channel] = value;
+            } else {
+                setLandmassSettingValue(landmassSettings, name, value);
+            }
+        });
+        if (!playing) {
+            break;
+        }
+        landmassGenerator.settings = landmassSettings;
+        landmassGenerator.setIsolineColor(sf::Color(static_cast<sf::Uint8>(contourColor[0] * 255),
+                                                    static_cast<sf::Uint8>(contourColor[1] * 255),
+                                                    static_cast<sf::Uint8>(contourColor[2] * 255)));
+        if (borderState() != bordersBefore || mapRenderer.getPendingTileCount() > 0) {
+            compositor.markDirty(bordersLayer);
+        }
+        inputStats.addSample(stageClock.restart());
+
+        if (landmassGenerator.update()) {
+            compositor.markDirty(terrainLayer);
+        }
+        updateStats.addSample(stageClock.restart());
+
+        terrainTime = sf::Time::Zero;
+        bordersTime = sf::Time::Zero;
+        target.setView(view);
+        target.clear(sf::Color::Black);
+        compositor.setVisible(bordersLayer, drawBorders);
+        compositor.draw(target);
+        layerRenders += compositor.getRenderCount();
+        compositeStats.addSample(stageClock.getElapsedTime() - terrainTime - bordersTime);
+        terrainStats.addSample(terrainTime);
+        bordersStats.addSample(bordersTime);
+        stageClock.restart();
+
+        target.display();
+        FrameArena::get().reset();
+        displayStats.addSample(stageClock.getElapsedTime());
+        frameStats.addSample(frameClock.getElapsedTime());
+    }
+
+    std::cout << layerRenders << " layer renders" << std::endl;
+    frameStats.print(std::cout);
+    inputStats.print(std::cout);
+    updateStats.print(std::cout);
+    terrainStats.print(std::cout);
+    bordersStats.print(std::cout);
+    compositeStats.print(std::cout);
+    displayStats.print(std::cout);
+    return 0;
+}
@@ -0,0 +1,58 @@
+#include "bench.hpp"
+#include <iostream>
+#include "../Map/raw_image_cache.hpp"
+#include "../Utils/frame_stats.hpp"
+
+int benchTextureStartup() {
+    const int runs = 5;
+    const char* const images[] = {"res/Earth-Small.png", "res/Earth-Large.png"};
+
+    // Textures need a GL context, no window is shown
+    sf::Context context;
+
+    for (const char* path : images) {
+        sf::Image image;
+        if (!image.loadFromFile(path)) {
+            std::cerr << "Skipping " << path << std::endl;
+            continue;
+        }
+        if (!RawImageCache::write(path, image)) {
+            std::cerr << "Failed to write the cache for " << path << std::endl;
+            return 1;
+        }
+        std::cout << "texture-startup: " << path << ", " << image.getSize().x << "x" << image.getSize().y << ", " << runs << " runs" << std::endl;
+
+        FrameStats pngDecode("png decode");
+        FrameStats pngUpload("png upload");
+        FrameStats cacheOpen("cache map + hash");
+        FrameStats cacheUpload("cache upload");
+        for (int run = 0; run < runs; run++) {
+            sf::Clock clock;
+            sf::Image decoded;
+            decoded.loadFromFile(path);
+            pngDecode.addSample(clock.restart());
+
+            sf::Texture pngTexture;
+            pngTexture.loadFromImage(decoded);
+            pngUpload.addSample(clock.restart());
+
+            RawImageCache cache;
+            if (!cache.open(path)) {
+                std::cerr << "Failed to open the cache for " << path << std::endl;
+                return 1;
+            }
+            cacheOpen.addSample(clock.restart());
+
+            sf::Texture cacheTexture;
+            cacheTexture.create(cache.getSize().x, cache.getSize().y);
+            cacheTexture.update(cache.getPixels());
+            cacheUpload.addSample(clock.restart());
+        }
+
+        pngDecode.print(std::cout);
+        pngUpload.print(std::cout);
+        cacheOpen.print(std::cout);
+        cacheUpload.print(std::cout);
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include "bench.hpp"
+#include <iostream>
+#include "../Map/domain_warp.hpp"
+#include "../Map/gen.hpp"
+#include "../Map/terrain_noise.hpp"
+#include "../Utils/frame_stats.hpp"
+#include "../Utils/thread_pool.hpp"
+
+namespace {
+
+// Million samples per second for a fill of the bench grid taking meanMs
+double throughput(double meanMs) {
+    return BENCH_GRID_WIDTH * BENCH_GRID_HEIGHT / (meanMs * 1000.0);
+}
+
+} // namespace
+
+int benchWarp() {
+    const int octaves = LandmassSettings().octaves;
+    const int warpOctaves = LandmassSettings().warpOctaves;
+    const double strength = 2.0;
+    const NoiseState::seed_type seed = LandmassSettings().seedValue;
+    const int runs = 20;
+
+    const std::shared_ptr<const NoiseState> noise = NoiseCache::global().get(seed);
+    const std::shared_ptr<const NoiseState> offsetX = NoiseCache::global().get(deriveNoiseSeed(seed, NoiseChannel::WarpX));
+    const std::shared_ptr<const NoiseState> offsetY = NoiseCache::global().get(deriveNoiseSeed(seed, NoiseChannel::WarpY));
+
+    BenchGrid plainGrid = makeBenchGrid();
+    BenchGrid warpXGrid = makeBenchGrid();
+    BenchGrid warpYGrid = makeBenchGrid();
+    BenchGrid separateGrid = makeBenchGrid();
+    BenchGrid fusedGrid = makeBenchGrid();
+
+    // All on the pool: the unwarped fill, the warp as three passes through full-size offset grids,
+    // and the fused tiled kernel
+    const NoiseColumnKernel plainKernel = selectNoiseKernel(octaves);
+    const NoiseColumnKernel offsetKernel = selectNoiseKernel(warpOctaves);
+    const DomainWarp warp(offsetX, offsetY, strength, warpOctaves);
+    const FusedNoise<1> fused({noise});
+    FrameStats plainStats("unwarped");
+    FrameStats separateStats("warp, 3 passes");
+    FrameStats fusedStats("warp, fused tiles");
+    for (int run = 0; run < runs; run++) {
+        sf::Clock clock;
+        ThreadPool::global().parallelFor(0, BENCH_GRID_WIDTH, 8, [&](std::size_t first, std::size_t last) {
+            plainKernel(*noise, BENCH_NOISE_FREQUENCY, BENCH_NOISE_FREQUENCY, octaves, plainGrid, first, last);
+        });
+        plainStats.addSample(clock.restart());
+
+        ThreadPool::global().parallelFor(0, BENCH_GRID_WIDTH, 8, [&](std::size_t first, std::size_t last) {
+            offsetKernel(*offsetX, BENCH_NOISE_FREQUENCY, BENCH_NOISE_FREQUENCY, warpOctaves, warpXGrid, first, last);
+        });
+        ThreadPool::global().parallelFor(0, BENCH_GRID_WIDTH, 8, [&](std::size_t first, std::size_t last) {
+            offsetKernel(*offsetY, BENCH_NOISE_FREQUENCY, BENCH_NOISE_FREQUENCY, warpOctaves, warpYGrid, first, last);
+        });
+        ThreadPool::global().parallelFor(0, BENCH_GRID_WIDTH, 8, [&](std::size_t first, std::size_t last) {
+            for (std::size_t x = first; x < last; ++x) {
+                for (std::size_t y = 0; y < BENCH_GRID_HEIGHT; ++y) {
+                    const double sampleX = x * BENCH_NOISE_FREQUENCY + strength * (warpXGrid[x][y] * 2 - 1);
+                    const double sampleY = y * BENCH_NOISE_FREQUENCY + strength * (warpYGrid[x][y] * 2 - 1);
+                    separateGrid[x][y] = siv::perlin_detail::RemapClamp_01(siv::perlin_detail::Octave2D(*noise, sampleX, sampleY, octaves, 0.5));
+                }
+            }
+        });
+        separateStats.addSample(clock.restart());
+
+        fillWarpedTiles(warp, fused, {octaves}, BENCH_NOISE_FREQUENCY, BENCH_NOISE_FREQUENCY, BENCH_GRID_WIDTH, BENCH_GRID_HEIGHT,
+            [&](std::size_t x, std::size_t y, const FusedNoise<1>::Sample& sample) {
+                fusedGrid[x][y] = sample[0];
+            });
+        fusedStats.addSample(clock.getElapsedTime());
+    }
+
+    const std::string title = "warp: " + std::to_string(octaves) + " octaves, " + std::to_string(warpOctaves) + " warp octaves";
+    const bool identical = reportComparison(title, separateGrid == fusedGrid, separateStats, fusedStats);
+    plainStats.print(std::cout);
+    std::cout << "warp: Msamples/s unwarped " << throughput(plainStats.getMeanMs()) << ", 3 passes "
+              << throughput(separateStats.getMeanMs()) << ", fused tiles " << throughput(fusedStats.getMeanMs()) << std::endl;
+
+    // The whole regeneration with and without the warp stage
+    LandmassSettings settings;
+    timeRegeneration(settings, runs, "regen without warp");
+    settings.warpStrength = static_cast<float>(strength);
+    timeRegeneration(settings, runs, "regen with warp");
+    return identical ? 0 : 1;
+}
@@ -8,33 +8,47 @@ CameraController::CameraController(sf::View& view, float moveSpeed, float zoomFa
 
 void CameraController::handleEvent(const sf::Event& event) {
     if (event.type == sf::Event::MouseWheelScrolled) {
-        if (event.mouseWheelScroll.delta > 0) { // Zoom in
-            zoomFactor = std::min(zoomFactor * 1.1f, maxZoom); // Increase zoom factor, clamp to maxZoom
-        } else if (event.mouseWheelScroll.delta < 0) { // Zoom out
-            zoomFactor = std::max(zoomFactor / 1.1f, minZoom); // Decrease zoom factor, clamp to minZoom
-        }
-
-        // Adjust view size based on updated zoom factor
-        view.setSize(1920.0f / zoomFactor, 1080.0f / zoomFactor);
+        scroll(event.mouseWheelScroll.delta);
     }
 }
 
-void CameraController::update() {
-    float zoomLevel = view.getSize().x / 1920.0f;
+void CameraController::scroll(float delta) {
+    if (delta > 0) { // Zoom in
+        zoomFactor = std::min(zoomFactor * 1.1f, maxZoom); // Increase zoom factor, clamp to maxZoom
+    } else if (delta < 0) { // Zoom out
+        zoomFactor = std::max(zoomFactor / 1.1f, minZoom); // Decrease zoom factor, clamp to minZoom
+    }
 
-    // Handle panning
+    // Adjust view size based on updated zoom factor
+    view.setSize(1920.0f / zoomFactor, 1080.0f / zoomFactor);
+}
+
+sf::Vector2f CameraController::readKeyboardPan() {
+    sf::Vector2f direction;
     if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left) || sf::Keyboard::isKeyPressed(sf::Keyboard::A)) {
-        view.move(-moveSpeed * zoomLevel, 0);
+        direction.x -= 1.0f;
     }
     if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right) || sf::Keyboard::isKeyPressed(sf::Keyboard::D)) {
-        view.move(moveSpeed * zoomLevel, 0);
+        direction.x += 1.0f;
     }
     if (sf::Keyboard::isKeyPressed(sf::Keyboard::Up) || sf::Keyboard::isKeyPressed(sf::Keyboard::W)) {
-        view.move(0, -moveSpeed * zoomLevel);
+        direction.y -= 1.0f;
     }
     if (sf::Keyboard::isKeyPressed(sf::Keyboard::Down) || sf::Keyboard::isKeyPressed(sf::Keyboard::S)) {
-        view.move(0, moveSpeed * zoomLevel);
+        direction.y += 1.0f;
     }
+    return direction;
+}
+
+void CameraController::update() {
+    update(readKeyboardPan());
+}
+
+void CameraController::update(const sf::Vector2f& panDirection) {
+    float zoomLevel = view.getSize().x / 1920.0f;
+
+    // Handle panning
+    view.move(panDirection.x * moveSpeed * zoomLevel, panDirection.y * moveSpeed * zoomLevel);
 
     // bird's eye view
 
@@ -58,6 +72,12 @@ float CameraController::getZoomFactor() const {
     return zoomFactor;
 }
 
+void CameraController::setState(const sf::Vector2f& center, const sf::Vector2f& size, float zoomFactor) {
+    this->zoomFactor = std::clamp(zoomFactor, minZoom, maxZoom);
+    view.setSize(size);
+    view.setCenter(center);
+}
+
 sf::Vector2f CameraController::getOffsetWithZoom() const {
     return view.getCenter() - sf::Vector2f(1920 / 2, 1080 / 2);
 }
@@ -17,7 +17,15 @@ public:
     CameraController(sf::View& view, float moveSpeed = 10.0f, float zoomFactor = 1.1f, float minZoom = 0.5f, float maxZoom = 10.0f);
     void handleEvent(const sf::Event& event);
     void update();
+
+    // The same steps driven by values instead of live input, used when replaying a recorded flight
+    void scroll(float delta);
+    void update(const sf::Vector2f& panDirection);
+    // -1, 0 or 1 per axis from the arrow and WASD keys
+    static sf::Vector2f readKeyboardPan();
     float getZoomFactor() const;
+    // Puts the camera where a recorded flight started
+    void setState(const sf::Vector2f& center, const sf::Vector2f& size, float zoomFactor);
     sf::Vector2f getOffsetWithZoom() const;
 };
 
@@ -0,0 +1,190 @@
+#include "recorder.hpp"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+void CameraRecording::begin(const sf::View& view, float zoomFactor) {
+    start.center = view.getCenter();
+    start.size = view.getSize();
+    start.zoomFactor = zoomFactor;
+    events.clear();
+    frameCount = 0;
+    lastPan = sf::Vector2f();
+    clock.restart();
+    recording = true;
+}
+
+void CameraRecording::end() {
+    recording = false;
+}
+
+bool CameraRecording::isRecording() const {
+    return recording;
+}
+
+void CameraRecording::push(CameraEvent::Type type, const sf::Vector2f& value, const std::string& name) {
+    CameraEvent event;
+    event.frame = frameCount;
+    event.timeMs = clock.getElapsedTime().asMicroseconds() / 1000.0f;
+    event.type = type;
+    event.value = value;
+    event.name = name;
+    events.push_back(std::move(event));
+}
+
+void CameraRecording::recordScroll(float delta) {
+    if (recording) {
+        push(CameraEvent::Type::Scroll, sf::Vector2f(delta, 0.0f));
+    }
+}
+
+void CameraRecording::recordPan(const sf::Vector2f& direction) {
+    if (recording && direction != lastPan) {
+        lastPan = direction;
+        push(CameraEvent::Type::Pan, direction);
+    }
+}
+
+void CameraRecording::recordSetting(const std::string& name, float value) {
+    if (recording) {
+        push(CameraEvent::Type::Setting, sf::Vector2f(value, 0.0f), name);
+    }
+}
+
+void CameraRecording::nextFrame() {
+    if (recording) {
+        ++frameCount;
+    }
+}
+
+bool CameraRecording::save(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Failed to write camera recording: " << path << std::endl;
+        return false;
+    }
+
+    file.precision(9);
+    file << "frames " << frameCount << '\n';
+    file << "view " << start.center.x << ' ' << start.center.y << ' ' << start.size.x << ' ' << start.size.y << ' '
+         << start.zoomFactor << '\n';
+    for (const CameraEvent& event : events) {
+        file << event.frame << ' ' << event.timeMs << ' ';
+        switch (event.type) {
+            case CameraEvent::Type::Scroll:
+                file << "scroll " << event.value.x;
+                break;
+            case CameraEvent::Type::Pan:
+                file << "pan " << event.value.x << ' ' << event.value.y;
+                break;
+            case CameraEvent::Type::Setting:
+                file << "set " << event.name << ' ' << event.value.x;
+                break;
+        }
+        file << '\n';
+    }
+    return static_cast<bool>(file);
+}
+
+bool CameraRecording::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open camera recording: " << path << std::endl;
+        return false;
+    }
+
+    start = CameraStart();
+    events.clear();
+    frameCount = 0;
+    recording = false;
+
+    std::string header;
+    if (!(file >> header >> frameCount) || header != "frames") {
+        std::cerr << "Invalid camera recording: " << path << std::endl;
+        return false;
+    }
+
+    std::string line;
+    std::getline(file, line);
+    while (std::getline(file, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        std::istringstream stream(line);
+        if (line.compare(0, 5, "view ") == 0 && events.empty()) {
+            std::string view;
+            if (!(stream >> view >> start.center.x >> start.center.y >> start.size.x >> start.size.y >> start.zoomFactor)) {
+                std::cerr << "Invalid camera view in " << path << ": " << line << std::endl;
+                return false;
+            }
+            continue;
+        }
+        CameraEvent event;
+        std::string type;
+        stream >> event.frame >> event.timeMs >> type;
+        if (type == "scroll") {
+            event.type = CameraEvent::Type::Scroll;
+            stream >> event.value.x;
+        } else if (type == "pan") {
+            event.type = CameraEvent::Type::Pan;
+            stream >> event.value.x >> event.value.y;
+        } else if (type == "set") {
+            event.type = CameraEvent::Type::Setting;
+            stream >> event.name >> event.value.x;
+        } else {
+            stream.setstate(std::ios::failbit);
+        }
+        if (!stream) {
+            std::cerr << "Invalid camera event in " << path << ": " << line << std::endl;
+            return false;
+        }
+        events.push_back(std::move(event));
+    }
+    return true;
+}
+
+const CameraStart& CameraRecording::getStart() const {
+    return start;
+}
+
+const std::vector<CameraEvent>& CameraRecording::getEvents() const {
+    return events;
+}
+
+std::uint32_t CameraRecording::getFrameCount() const {
+    return frameCount;
+}
+
+CameraReplay::CameraReplay(const CameraRecording& recording) : recording(recording) {}
+
+bool CameraReplay::step(CameraController& camera, const SettingCallback& onSetting) {
+    if (frame >= recording.getFrameCount()) {
+        return false;
+    }
+
+    const std::vector<CameraEvent>& events = recording.getEvents();
+    for (; nextEvent < events.size() && events[nextEvent].frame == frame; nextEvent++) {
+        const CameraEvent& event = events[nextEvent];
+        switch (event.type) {
+            case CameraEvent::Type::Scroll:
+                camera.scroll(event.value.x);
+                break;
+            case CameraEvent::Type::Pan:
+                pan = event.value;
+                break;
+            case CameraEvent::Type::Setting:
+                if (onSetting) {
+                    onSetting(event.name, event.value.x);
+                }
+                break;
+        }
+    }
+
+    camera.update(pan);
+    ++frame;
+    return true;
+}
+
+std::uint32_t CameraReplay::getFrame() const {
+    return frame;
+}
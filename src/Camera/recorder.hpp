@@ -0,0 +1,85 @@
+#ifndef CAMERA_RECORDER_HPP
+#define CAMERA_RECORDER_HPP
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "controller.hpp"
+
+struct CameraEvent {
+    enum class Type { Scroll, Pan, Setting };
+
+    std::uint32_t frame = 0;
+    float timeMs = 0.0f;     // wall time when recorded, replay goes by frame
+    Type type = Type::Scroll;
+    sf::Vector2f value;      // scroll delta in x, or the pan direction held from this frame on
+    std::string name;        // setting name, its value is in value.x
+};
+
+// Where the camera was when recording began
+struct CameraStart {
+    sf::Vector2f center{1920.0f / 2, 1080.0f / 2};
+    sf::Vector2f size{1920.0f, 1080.0f};
+    float zoomFactor = 1.0f;
+};
+
+// Camera input and setting changes of a session. After the header
+//   frames <count>
+//   view <center x> <center y> <width> <height> <zoom factor>
+// events are stored one per line:
+//   <frame> <ms> scroll <delta>
+//   <frame> <ms> pan <x> <y>
+//   <frame> <ms> set <name> <value>
+class CameraRecording {
+public:
+    void begin(const sf::View& view, float zoomFactor);
+    void end();
+    bool isRecording() const;
+
+    void recordScroll(float delta);
+    // Only changes of the held direction are stored
+    void recordPan(const sf::Vector2f& direction);
+    void recordSetting(const std::string& name, float value);
+    // Call once at the end of every recorded frame
+    void nextFrame();
+
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+
+    // Recordings without a view line start from the default view
+    const CameraStart& getStart() const;
+    const std::vector<CameraEvent>& getEvents() const;
+    std::uint32_t getFrameCount() const;
+
+private:
+    CameraStart start;
+    std::vector<CameraEvent> events;
+    std::uint32_t frameCount = 0;
+    bool recording = false;
+    sf::Clock clock;
+    sf::Vector2f lastPan;
+
+    void push(CameraEvent::Type type, const sf::Vector2f& value, const std::string& name = std::string());
+};
+
+// Plays a recording back frame by frame, the same frames always get the same input
+class CameraReplay {
+public:
+    using SettingCallback = std::function<void(const std::string& name, float value)>;
+
+    explicit CameraReplay(const CameraRecording& recording);
+
+    // Applies one frame of input to the camera, false once the recording is exhausted
+    bool step(CameraController& camera, const SettingCallback& onSetting);
+    std::uint32_t getFrame() const;
+
+private:
+    const CameraRecording& recording;
+    std::size_t nextEvent = 0;
+    std::uint32_t frame = 0;
+    sf::Vector2f pan;
+};
+
+#endif // CAMERA_RECORDER_HPP
@@ -0,0 +1,17 @@
+#include "biomes.hpp"
+
+Biome classifyBiome(double height, double moisture, double temperature) {
+    // octave2D_01 mostly lands within 0.3..0.7, the bands are cut around its middle
+    const double climate = temperature - (height - 0.5) * 0.4;
+
+    if (climate < 0.44) {
+        return moisture < 0.5 ? Biome::Tundra : Biome::Taiga;
+    }
+    if (climate < 0.56) {
+        return moisture < 0.46 ? Biome::Grassland : Biome::Forest;
+    }
+    if (moisture < 0.42) {
+        return Biome::Desert;
+    }
+    return moisture < 0.56 ? Biome::Savanna : Biome::Rainforest;
+}
@@ -0,0 +1,23 @@
+#ifndef MAP_BIOMES_HPP
+#define MAP_BIOMES_HPP
+
+#include <cstdint>
+
+enum class Biome : std::uint8_t {
+    None,         // biomes off, the height classes alone pick the colour
+    Tundra,
+    Taiga,
+    Grassland,
+    Forest,
+    Savanna,
+    Desert,
+    Rainforest,
+};
+
+constexpr int BIOME_COUNT = 8;
+
+// Climate of a cell from its height, moisture and temperature channels, all 0..1. Higher ground is
+// colder. Water and snow stay with the height thresholds, the biome recolours the plains between them
+Biome classifyBiome(double height, double moisture, double temperature);
+
+#endif // MAP_BIOMES_HPP
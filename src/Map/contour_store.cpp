@@ -0,0 +1,135 @@
+#include "contour_store.hpp"
+#include <nlohmann/json.hpp>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+// Accepts exactly [[int, ...], ...] and writes it straight into the store
+class ContourSaxHandler : public nlohmann::json_sax<nlohmann::json> {
+public:
+    explicit ContourSaxHandler(ContourStore& store) : store(store) {}
+
+    bool null() override { return false; }
+    bool boolean(bool) override { return false; }
+    bool number_integer(number_integer_t value) override { return addCoordinate(value); }
+    bool number_unsigned(number_unsigned_t value) override { return addCoordinate(static_cast<number_integer_t>(value)); }
+    bool number_float(number_float_t, const string_t&) override { return false; }
+    bool string(string_t&) override { return false; }
+    bool binary(binary_t&) override { return false; }
+    bool start_object(std::size_t) override { return false; }
+    bool key(string_t&) override { return false; }
+    bool end_object() override { return false; }
+
+    bool start_array(std::size_t) override {
+        if (++depth == 2) {
+            store.beginContour();
+        }
+        return depth <= 2;
+    }
+
+    bool end_array() override {
+        --depth;
+        return true;
+    }
+
+    bool parse_error(std::size_t position, const std::string&, const nlohmann::detail::exception& error) override {
+        std::cerr << "Failed to parse contours at byte " << position << ": " << error.what() << std::endl;
+        return false;
+    }
+
+private:
+    ContourStore& store;
+    int depth = 0;
+
+    bool addCoordinate(number_integer_t value) {
+        if (depth != 2) {
+            return false;
+        }
+        store.addCoordinate(static_cast<int>(value));
+        return true;
+    }
+};
+
+} // namespace
+
+ContourStore::ContourStore() : offsets(1, 0) {}
+
+bool ContourStore::loadFromJSON(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open contours file: " << path << std::endl;
+        return false;
+    }
+
+    clear();
+    ContourSaxHandler handler(*this);
+    if (!nlohmann::json::sax_parse(file, &handler)) {
+        clear();
+        return false;
+    }
+    shrinkToFit();
+    return true;
+}
+
+bool ContourStore::saveToJSON(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Failed to write contours file: " << path << std::endl;
+        return false;
+    }
+
+    file << '[';
+    for (std::size_t c = 0; c < getContourCount(); c++) {
+        file << (c > 0 ? ", [" : "[");
+        const ContourView contour = getContour(c);
+        for (std::size_t i = 0; i < contour.size; i++) {
+            if (i > 0) {
+                file << ", ";
+            }
+            file << contour[i];
+        }
+        file << ']';
+    }
+    file << ']';
+    return static_cast<bool>(file);
+}
+
+void ContourStore::beginContour() {
+    offsets.push_back(static_cast<std::uint32_t>(coordinates.size()));
+}
+
+void ContourStore::addCoordinate(int value) {
+    coordinates.push_back(value);
+    offsets.back() = static_cast<std::uint32_t>(coordinates.size());
+}
+
+void ContourStore::clear() {
+    coordinates.clear();
+    offsets.assign(1, 0);
+}
+
+void ContourStore::shrinkToFit() {
+    coordinates.shrink_to_fit();
+    offsets.shrink_to_fit();
+}
+
+std::size_t ContourStore::getContourCount() const {
+    return offsets.size() - 1;
+}
+
+std::size_t ContourStore::getPointCount() const {
+    return coordinates.size() / 2;
+}
+
+ContourView ContourStore::getContour(std::size_t index) const {
+    return {coordinates.data() + offsets[index], offsets[index + 1] - offsets[index]};
+}
+
+const std::vector<int>& ContourStore::getCoordinates() const {
+    return coordinates;
+}
+
+std::size_t ContourStore::getMemoryUsage() const {
+    return coordinates.capacity() * sizeof(int) + offsets.capacity() * sizeof(std::uint32_t);
+}
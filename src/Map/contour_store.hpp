@@ -0,0 +1,46 @@
+#ifndef MAP_CONTOUR_STORE_HPP
+#define MAP_CONTOUR_STORE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Read-only window onto one contour's interleaved x, y coordinates
+struct ContourView {
+    const int* data = nullptr;
+    std::size_t size = 0;   // number of ints, twice the point count
+
+    const int* begin() const { return data; }
+    const int* end() const { return data + size; }
+    int operator[](std::size_t i) const { return data[i]; }
+    std::size_t getPointCount() const { return size / 2; }
+};
+
+// All contours in one coordinate buffer, contour i spans [offsets[i], offsets[i + 1])
+class ContourStore {
+public:
+    ContourStore();
+
+    // Streams a JSON array of flat [x0, y0, x1, y1, ...] arrays without building a DOM
+    bool loadFromJSON(const std::string& path);
+    // Writes the same format loadFromJSON reads
+    bool saveToJSON(const std::string& path) const;
+
+    void beginContour();
+    void addCoordinate(int value);
+    void clear();
+    void shrinkToFit();
+
+    std::size_t getContourCount() const;
+    std::size_t getPointCount() const;
+    ContourView getContour(std::size_t index) const;
+    const std::vector<int>& getCoordinates() const;
+
+    std::size_t getMemoryUsage() const;
+
+private:
+    std::vector<int> coordinates;
+    std::vector<std::uint32_t> offsets;
+};
+
+#endif // MAP_CONTOUR_STORE_HPP
@@ -10,26 +10,66 @@
 #include <nlohmann/json.hpp>
 #include <SFML/Graphics.hpp>
 #include <iostream>
-#include "../Utils/progressBar.hpp"
+#include "../Utils/memory_registry.hpp"
+#include "../Utils/progressbar.hpp"
+#include "../Utils/thread_pool.hpp"
 #include "../Camera/controller.hpp"
+#include "contour_store.hpp"
+#include "isolines.hpp"
 
 class Contours {
 private:
-    std::vector<std::vector<int>> contours;
+    // Everything a load produces, built off the main thread
+    struct LoadedContours {
+        ContourStore store;
+        sf::Vector2f minBounds;
+        sf::Vector2f maxBounds;
+        sf::VertexArray mesh{sf::Lines};
+        bool valid = false;   // false when the file could not be read
+    };
+
+    ContourStore store;
     std::string contoursPath;
     sf::Color contourColor = sf::Color::Green;
-    void loadContours();
     sf::Vector2f minBounds;
     sf::Vector2f maxBounds;
+    sf::VertexArray mesh{sf::Lines};   // every contour segment, in contour coordinates
+    std::future<LoadedContours> pendingLoad;
+    ProgressBar* loadProgress = nullptr;
+    bool loaded = false;
+    bool failed = false;
+    bool worldSpace = false;   // lines are already in world coordinates, no fit transform
     bool isPointInContour(int x, int y, const std::vector<int>& contour);
 
-    void calculateBounds();
+    static LoadedContours loadContours(const std::string& path, sf::Color color);
+    static LoadedContours prepareContours(ContourStore store, sf::Color color);
+    static void calculateBounds(LoadedContours& contours);
+    static void buildMesh(LoadedContours& contours, sf::Color color);
+    // False for a failed load, the current contours are kept
+    bool adopt(LoadedContours&& contours);
 public:
     ~Contours();
     Contours(std::string contoursPath);
-    std::vector<std::vector<int>> getContours();
-    void draw(sf::RenderWindow& window, float zoomFactor);
+    const ContourStore& getContours() const;
+    // Fits the contour bounds to the target, centred, then applies zoomFactor
+    sf::Transform getTransform(const sf::Vector2u& targetSize, float zoomFactor) const;
+    void draw(sf::RenderTarget& target, float zoomFactor);
+    std::size_t getSegmentCount() const;
+    // Coordinates and line mesh as <name>.store and <name>.mesh
+    void reportMemory(MemoryRegistry& registry, const std::string& name) const;
+    // Starts loading on the shared pool and returns immediately
     void asyncLoadContours(ProgressBar& progressBar);
+    // Loads on the calling thread, for loader jobs that schedule the work themselves, false on failure
+    bool load();
+    // Takes over a finished load without waiting, true once the contours are loaded
+    bool update();
+    bool isLoaded() const;
+    // The last load could not read the contours file
+    bool hasFailed() const;
+    // Replaces the contours, e.g. with the output of EdgeContourExtractor
+    void setContours(ContourStore contours);
+    // Replaces the contours with lines already in world coordinates, e.g. projected isolines
+    void setIsolines(const std::vector<Isoline>& isolines);
     void changeColor(sf::Color color);
     void handleEvents(sf::Event& event);
     void setSelectedContour(std::vector<int> contour);
@@ -1,85 +1,211 @@
 #include "contours.hpp"
+#include <chrono>
+#include <limits>
 
 Contours::Contours(std::string contoursPath) : contoursPath(contoursPath) {
 }
 
-void Contours::loadContours() {
-    std::ifstream file(contoursPath);
-    nlohmann::json contoursJson = nlohmann::json::parse(file);
-    contours = contoursJson.get<std::vector<std::vector<int>>>();
+Contours::LoadedContours Contours::loadContours(const std::string& path, sf::Color color) {
+    ContourStore store;
+    if (!store.loadFromJSON(path)) {
+        return LoadedContours();
+    }
+    return prepareContours(std::move(store), color);
 }
 
-std::vector<std::vector<int>> Contours::getContours() {
+Contours::LoadedContours Contours::prepareContours(ContourStore store, sf::Color color) {
+    LoadedContours contours;
+    contours.store = std::move(store);
+
+    // Bounds and the line mesh only change with the data, not per frame
+    calculateBounds(contours);
+    buildMesh(contours, color);
+    contours.valid = true;
     return contours;
 }
 
+void Contours::setContours(ContourStore contours) {
+    worldSpace = false;
+    adopt(prepareContours(std::move(contours), contourColor));
+}
+
+const ContourStore& Contours::getContours() const {
+    return store;
+}
+
 
-void Contours::calculateBounds() {
+void Contours::calculateBounds(LoadedContours& contours) {
     // Initialize bounds with extreme values
-    minBounds = sf::Vector2f(std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
-    maxBounds = sf::Vector2f(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest());
-
-    for (const auto& contour : contours) {
-        for (size_t i = 0; i < contour.size(); i += 2) {
-            float x = contour[i];
-            float y = contour[i + 1];
-            minBounds.x = std::min(minBounds.x, x);
-            minBounds.y = std::min(minBounds.y, y);
-            maxBounds.x = std::max(maxBounds.x, x);
-            maxBounds.y = std::max(maxBounds.y, y);
+    contours.minBounds = sf::Vector2f(std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+    contours.maxBounds = sf::Vector2f(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest());
+
+    const std::vector<int>& coordinates = contours.store.getCoordinates();
+    for (size_t i = 0; i + 1 < coordinates.size(); i += 2) {
+        float x = coordinates[i];
+        float y = coordinates[i + 1];
+        contours.minBounds.x = std::min(contours.minBounds.x, x);
+        contours.minBounds.y = std::min(contours.minBounds.y, y);
+        contours.maxBounds.x = std::max(contours.maxBounds.x, x);
+        contours.maxBounds.y = std::max(contours.maxBounds.y, y);
+    }
+}
+
+
+void Contours::buildMesh(LoadedContours& contours, sf::Color color) {
+    const ContourStore& store = contours.store;
+    std::size_t segmentCount = 0;
+    for (std::size_t c = 0; c < store.getContourCount(); c++) {
+        const std::size_t points = store.getContour(c).getPointCount();
+        if (points >= 2) {
+            segmentCount += points - 1;
+        }
+    }
+
+    // One sf::Lines batch for all contours, a strip of n points becomes n - 1 segments
+    sf::VertexArray& mesh = contours.mesh;
+    mesh.clear();
+    mesh.resize(segmentCount * 2);
+    std::size_t vertex = 0;
+    for (std::size_t c = 0; c < store.getContourCount(); c++) {
+        const ContourView contour = store.getContour(c);
+        for (size_t i = 2; i + 1 < contour.size; i += 2) {
+            mesh[vertex++] = sf::Vertex(sf::Vector2f(contour[i - 2], contour[i - 1]), color);
+            mesh[vertex++] = sf::Vertex(sf::Vector2f(contour[i], contour[i + 1]), color);
         }
     }
 }
 
+bool Contours::adopt(LoadedContours&& contours) {
+    failed = !contours.valid;
+    if (failed) {
+        return false;
+    }
+
+    store = std::move(contours.store);
+    minBounds = contours.minBounds;
+    maxBounds = contours.maxBounds;
+    mesh = std::move(contours.mesh);
+    loaded = true;
 
-void Contours::draw(sf::RenderWindow& window, float zoomFactor) {
-    // Define contour bounds (assuming they were already calculated)
-    sf::Vector2u windowSize = window.getSize();
+    // The colour may have changed while the worker was busy
+    for (std::size_t i = 0; i < mesh.getVertexCount(); i++) {
+        mesh[i].color = contourColor;
+    }
+    return true;
+}
+
+sf::Transform Contours::getTransform(const sf::Vector2u& targetSize, float zoomFactor) const {
     float contourWidth = maxBounds.x - minBounds.x;
     float contourHeight = maxBounds.y - minBounds.y;
 
     // Calculate scaling factors
-    float scaleX = static_cast<float>(windowSize.x) / contourWidth;
-    float scaleY = static_cast<float>(windowSize.y) / contourHeight;
+    float scaleX = static_cast<float>(targetSize.x) / contourWidth;
+    float scaleY = static_cast<float>(targetSize.y) / contourHeight;
     float scale = std::min(scaleX, scaleY) * zoomFactor;
 
     // Calculate offset to center the contours
     sf::Vector2f offset(
-        (windowSize.x - contourWidth * scale) / 2.0f - minBounds.x * scale,
-        (windowSize.y - contourHeight * scale) / 2.0f - minBounds.y * scale
+        (targetSize.x - contourWidth * scale) / 2.0f - minBounds.x * scale,
+        (targetSize.y - contourHeight * scale) / 2.0f - minBounds.y * scale
     );
 
-    // Draw contours with applied scale and offset
-    for (const auto& contour : contours) {
-        sf::VertexArray lineStrip(sf::PrimitiveType::LineStrip, contour.size() / 2);
-        for (size_t i = 0; i < contour.size(); i += 2) {
-            float x = contour[i] * scale + offset.x;
-            float y = contour[i + 1] * scale + offset.y;
-            lineStrip[i / 2].position = sf::Vector2f(x, y);
-            lineStrip[i / 2].color = contourColor;
+    sf::Transform transform;
+    transform.translate(offset);
+    transform.scale(scale, scale);
+    return transform;
+}
+
+void Contours::draw(sf::RenderTarget& target, float zoomFactor) {
+    if (!update() || mesh.getVertexCount() == 0) {
+        return;
+    }
+
+    // Scale and offset are applied by the transform, the mesh itself never changes
+    sf::RenderStates states;
+    if (!worldSpace) {
+        states.transform = getTransform(target.getSize(), zoomFactor);
+    }
+    target.draw(mesh, states);
+}
+
+std::size_t Contours::getSegmentCount() const {
+    return mesh.getVertexCount() / 2;
+}
+
+void Contours::reportMemory(MemoryRegistry& registry, const std::string& name) const {
+    // The store keeps its coordinates and offsets in one vector each
+    registry.report(name + ".store", {store.getMemoryUsage(), store.getContourCount() > 0 ? 2u : 0u});
+    registry.report(name + ".mesh", {mesh.getVertexCount() * sizeof(sf::Vertex), mesh.getVertexCount() > 0 ? 1u : 0u});
+}
+
+void Contours::asyncLoadContours(ProgressBar& progressBar) {
+    loadProgress = &progressBar;
+    pendingLoad = ThreadPool::global().async([path = contoursPath, color = contourColor]() { return loadContours(path, color); });
+}
+
+bool Contours::load() {
+    return adopt(loadContours(contoursPath, contourColor));
+}
+
+bool Contours::update() {
+    if (pendingLoad.valid() && pendingLoad.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        adopt(pendingLoad.get());
+        if (loadProgress) {
+            loadProgress->incrementProgress();
+            loadProgress = nullptr;
         }
-        window.draw(lineStrip);
     }
+    return loaded;
+}
 
-    calculateBounds();
+bool Contours::isLoaded() const {
+    return loaded;
 }
 
+bool Contours::hasFailed() const {
+    return failed;
+}
 
+void Contours::setIsolines(const std::vector<Isoline>& isolines) {
+    std::size_t segmentCount = 0;
+    for (const auto& isoline : isolines) {
+        if (isoline.points.size() >= 2) {
+            segmentCount += isoline.points.size() - 1;
+        }
+    }
 
+    // Reuses the mesh allocation, isolines are rebuilt whenever the thresholds move
+    mesh.resize(segmentCount * 2);
+    std::size_t vertex = 0;
+    for (const auto& isoline : isolines) {
+        for (size_t i = 1; i < isoline.points.size(); i++) {
+            mesh[vertex++] = sf::Vertex(isoline.points[i - 1], contourColor);
+            mesh[vertex++] = sf::Vertex(isoline.points[i], contourColor);
+        }
+    }
 
-void Contours::asyncLoadContours(ProgressBar& progressBar) {
-    std::future<void> future = std::async(std::launch::async, [this, &progressBar]() {
-        loadContours();
-        progressBar.incrementProgress();
-    });
-    future.get();
+    store.clear();
+    worldSpace = true;
+    loaded = true;
+    failed = false;
 }
 
 
 void Contours::changeColor(sf::Color color) {
+    if (color == contourColor) {
+        return;
+    }
     contourColor = color;
+    for (std::size_t i = 0; i < mesh.getVertexCount(); i++) {
+        mesh[i].color = color;
+    }
 }
 
 Contours::~Contours() {
-    contours.clear();
+    // A load still in flight is waited for here, the worker only touches its own result
+    if (pendingLoad.valid()) {
+        pendingLoad.wait();
+    }
+    store.clear();
+    mesh.clear();
 }
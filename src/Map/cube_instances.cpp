@@ -0,0 +1,345 @@
+#include "cube_instances.hpp"
+#include <SFML/OpenGL.hpp>
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+// Only OpenGL 1.1 is declared on every platform, the rest is loaded through SFML
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+namespace {
+
+constexpr GLenum ARRAY_BUFFER = 0x8892;
+constexpr GLenum STATIC_DRAW = 0x88E4;
+constexpr GLenum VERTEX_SHADER = 0x8B31;
+constexpr GLenum FRAGMENT_SHADER = 0x8B30;
+constexpr GLenum COMPILE_STATUS = 0x8B81;
+constexpr GLenum LINK_STATUS = 0x8B82;
+
+// Attribute locations, bound before linking
+constexpr GLuint CORNER_ATTRIBUTE = 0;
+constexpr GLuint CELL_ATTRIBUTE = 1;
+constexpr GLuint HEIGHT_ATTRIBUTE = 2;
+constexpr GLuint BIOME_ATTRIBUTE = 3;
+
+struct GlFunctions {
+    void (APIENTRY* genBuffers)(GLsizei, GLuint*);
+    void (APIENTRY* deleteBuffers)(GLsizei, const GLuint*);
+    void (APIENTRY* bindBuffer)(GLenum, GLuint);
+    void (APIENTRY* bufferData)(GLenum, std::ptrdiff_t, const void*, GLenum);
+    GLuint (APIENTRY* createShader)(GLenum);
+    void (APIENTRY* deleteShader)(GLuint);
+    void (APIENTRY* shaderSource)(GLuint, GLsizei, const char* const*, const GLint*);
+    void (APIENTRY* compileShader)(GLuint);
+    void (APIENTRY* getShaderiv)(GLuint, GLenum, GLint*);
+    void (APIENTRY* getShaderInfoLog)(GLuint, GLsizei, GLsizei*, char*);
+    GLuint (APIENTRY* createProgram)();
+    void (APIENTRY* deleteProgram)(GLuint);
+    void (APIENTRY* attachShader)(GLuint, GLuint);
+    void (APIENTRY* bindAttribLocation)(GLuint, GLuint, const char*);
+    void (APIENTRY* linkProgram)(GLuint);
+    void (APIENTRY* getProgramiv)(GLuint, GLenum, GLint*);
+    void (APIENTRY* getProgramInfoLog)(GLuint, GLsizei, GLsizei*, char*);
+    void (APIENTRY* useProgram)(GLuint);
+    GLint (APIENTRY* getUniformLocation)(GLuint, const char*);
+    void (APIENTRY* uniform1f)(GLint, GLfloat);
+    void (APIENTRY* uniform2f)(GLint, GLfloat, GLfloat);
+    void (APIENTRY* uniform3f)(GLint, GLfloat, GLfloat, GLfloat);
+    void (APIENTRY* uniform4fv)(GLint, GLsizei, const GLfloat*);
+    void (APIENTRY* uniformMatrix4fv)(GLint, GLsizei, GLboolean, const GLfloat*);
+    void (APIENTRY* enableVertexAttribArray)(GLuint);
+    void (APIENTRY* disableVertexAttribArray)(GLuint);
+    void (APIENTRY* vertexAttribPointer)(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*);
+    void (APIENTRY* vertexAttribDivisor)(GLuint, GLuint);
+    void (APIENTRY* drawArraysInstanced)(GLenum, GLint, GLsizei, GLsizei);
+    void (APIENTRY* viewport)(GLint, GLint, GLsizei, GLsizei);
+};
+
+GlFunctions gl;
+
+template <typename Function>
+bool load(Function& function, const char* name) {
+    function = reinterpret_cast<Function>(sf::Context::getFunction(name));
+    return function != nullptr;
+}
+
+bool loadFunctions() {
+    return load(gl.genBuffers, "glGenBuffers")
+        && load(gl.deleteBuffers, "glDeleteBuffers")
+        && load(gl.bindBuffer, "glBindBuffer")
+        && load(gl.bufferData, "glBufferData")
+        && load(gl.createShader, "glCreateShader")
+        && load(gl.deleteShader, "glDeleteShader")
+        && load(gl.shaderSource, "glShaderSource")
+        && load(gl.compileShader, "glCompileShader")
+        && load(gl.getShaderiv, "glGetShaderiv")
+        && load(gl.getShaderInfoLog, "glGetShaderInfoLog")
+        && load(gl.createProgram, "glCreateProgram")
+        && load(gl.deleteProgram, "glDeleteProgram")
+        && load(gl.attachShader, "glAttachShader")
+        && load(gl.bindAttribLocation, "glBindAttribLocation")
+        && load(gl.linkProgram, "glLinkProgram")
+        && load(gl.getProgramiv, "glGetProgramiv")
+        && load(gl.getProgramInfoLog, "glGetProgramInfoLog")
+        && load(gl.useProgram, "glUseProgram")
+        && load(gl.getUniformLocation, "glGetUniformLocation")
+        && load(gl.uniform1f, "glUniform1f")
+        && load(gl.uniform2f, "glUniform2f")
+        && load(gl.uniform3f, "glUniform3f")
+        && load(gl.uniform4fv, "glUniform4fv")
+        && load(gl.uniformMatrix4fv, "glUniformMatrix4fv")
+        && load(gl.enableVertexAttribArray, "glEnableVertexAttribArray")
+        && load(gl.disableVertexAttribArray, "glDisableVertexAttribArray")
+        && load(gl.vertexAttribPointer, "glVertexAttribPointer")
+        && load(gl.vertexAttribDivisor, "glVertexAttribDivisor")
+        && load(gl.drawArraysInstanced, "glDrawArraysInstanced")
+        && load(gl.viewport, "glViewport");
+}
+
+const char* VERTEX_SOURCE = R"(#version 330
+in vec4 corner;        // offset from the cell's top corner, 1 where raised to the cube top, 1 on a side face
+in vec2 cell;
+in float height;       // 0..1
+in float biome;
+
+uniform mat4 viewMatrix;
+uniform vec2 isoStep;
+uniform float heightMultiplier;
+uniform vec3 thresholds;
+uniform vec4 topColors[4];
+uniform vec4 sideColors[4];
+uniform vec4 biomeTopColors[8];
+uniform vec4 biomeSideColors[8];
+
+out vec4 color;
+
+void main() {
+    vec2 iso = vec2((cell.x - cell.y) * isoStep.x, (cell.x + cell.y) * isoStep.y);
+    vec2 position = iso + corner.xy - vec2(0.0, corner.z * height * heightMultiplier);
+    int index = height < thresholds.x ? 0 : (height < thresholds.y ? 1 : (height < thresholds.z ? 2 : 3));
+    int biomeIndex = int(biome);
+    if (index == 1 && biomeIndex > 0) {
+        color = corner.w > 0.5 ? biomeSideColors[biomeIndex] : biomeTopColors[biomeIndex];
+    } else {
+        color = corner.w > 0.5 ? sideColors[index] : topColors[index];
+    }
+    gl_Position = viewMatrix * vec4(position, 0.0, 1.0);
+}
+)";
+
+const char* FRAGMENT_SOURCE = R"(#version 330
+in vec4 color;
+out vec4 fragmentColor;
+
+void main() {
+    fragmentColor = color;
+}
+)";
+
+GLuint compile(GLenum type, const char* source) {
+    const GLuint shader = gl.createShader(type);
+    gl.shaderSource(shader, 1, &source, nullptr);
+    gl.compileShader(shader);
+
+    GLint status = 0;
+    gl.getShaderiv(shader, COMPILE_STATUS, &status);
+    if (!status) {
+        char log[1024] = {};
+        gl.getShaderInfoLog(shader, sizeof(log), nullptr, log);
+        std::cerr << "Failed to compile the cube shader: " << log << std::endl;
+        gl.deleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+void toFloats(const sf::Color& color, GLfloat* out) {
+    out[0] = color.r / 255.0f;
+    out[1] = color.g / 255.0f;
+    out[2] = color.b / 255.0f;
+    out[3] = color.a / 255.0f;
+}
+
+} // namespace
+
+CubeInstanceRenderer::CubeInstanceRenderer(float halfStep, float quarterStep) : halfStep(halfStep), quarterStep(quarterStep) {}
+
+CubeInstanceRenderer::~CubeInstanceRenderer() {
+    if (!initialised) {
+        return;
+    }
+    // Any context will do, the objects live in SFML's shared context group
+    sf::Context context;
+    gl.deleteBuffers(1, &meshBuffer);
+    gl.deleteBuffers(1, &instanceBuffer);
+    gl.deleteProgram(program);
+}
+
+bool CubeInstanceRenderer::initialise() {
+    if (!loadFunctions()) {
+        std::cerr << "Instanced cubes need OpenGL 3.3, falling back to vertex arrays" << std::endl;
+        return false;
+    }
+
+    const GLuint vertexShader = compile(VERTEX_SHADER, VERTEX_SOURCE);
+    const GLuint fragmentShader = compile(FRAGMENT_SHADER, FRAGMENT_SOURCE);
+    if (!vertexShader || !fragmentShader) {
+        gl.deleteShader(vertexShader);
+        gl.deleteShader(fragmentShader);
+        return false;
+    }
+    program = gl.createProgram();
+    gl.attachShader(program, vertexShader);
+    gl.attachShader(program, fragmentShader);
+    gl.bindAttribLocation(program, CORNER_ATTRIBUTE, "corner");
+    gl.bindAttribLocation(program, CELL_ATTRIBUTE, "cell");
+    gl.bindAttribLocation(program, HEIGHT_ATTRIBUTE, "height");
+    gl.bindAttribLocation(program, BIOME_ATTRIBUTE, "biome");
+    gl.linkProgram(program);
+    gl.deleteShader(vertexShader);
+    gl.deleteShader(fragmentShader);
+
+    GLint status = 0;
+    gl.getProgramiv(program, LINK_STATUS, &status);
+    if (!status) {
+        char log[1024] = {};
+        gl.getProgramInfoLog(program, sizeof(log), nullptr, log);
+        std::cerr << "Failed to link the cube shader: " << log << std::endl;
+        gl.deleteProgram(program);
+        program = 0;
+        return false;
+    }
+    uniforms.viewMatrix = gl.getUniformLocation(program, "viewMatrix");
+    uniforms.isoStep = gl.getUniformLocation(program, "isoStep");
+    uniforms.heightMultiplier = gl.getUniformLocation(program, "heightMultiplier");
+    uniforms.thresholds = gl.getUniformLocation(program, "thresholds");
+    uniforms.topColors = gl.getUniformLocation(program, "topColors");
+    uniforms.sideColors = gl.getUniformLocation(program, "sideColors");
+    uniforms.biomeTopColors = gl.getUniformLocation(program, "biomeTopColors");
+    uniforms.biomeSideColors = gl.getUniformLocation(program, "biomeSideColors");
+
+    // The corners addCubeVertices emits, as triangles: x, y offset, raised, side face
+    const std::array<GLfloat, 4> topLeft = {0.0f, 0.0f, 1.0f, 0.0f};
+    const std::array<GLfloat, 4> topRight = {halfStep, -quarterStep, 1.0f, 0.0f};
+    const std::array<GLfloat, 4> bottomLeft = {-halfStep, -quarterStep, 1.0f, 0.0f};
+    const std::array<GLfloat, 4> bottomRight = {0.0f, -halfStep, 1.0f, 0.0f};
+    const auto side = [](std::array<GLfloat, 4> corner, bool raised) {
+        corner[2] = raised ? 1.0f : 0.0f;
+        corner[3] = 1.0f;
+        return corner;
+    };
+    const std::array<std::array<GLfloat, 4>, 4> faces[3] = {
+        {topLeft, topRight, bottomRight, bottomLeft},
+        {side(bottomLeft, true), side(bottomLeft, false), side(topLeft, false), side(topLeft, true)},
+        {side(bottomRight, true), side(bottomRight, false), side(topRight, false), side(topRight, true)},
+    };
+    std::vector<GLfloat> mesh;
+    for (const auto& face : faces) {
+        for (int index : {0, 1, 2, 0, 2, 3}) {
+            mesh.insert(mesh.end(), face[index].begin(), face[index].end());
+        }
+    }
+
+    gl.genBuffers(1, &meshBuffer);
+    gl.bindBuffer(ARRAY_BUFFER, meshBuffer);
+    gl.bufferData(ARRAY_BUFFER, static_cast<std::ptrdiff_t>(mesh.size() * sizeof(GLfloat)), mesh.data(), STATIC_DRAW);
+    gl.genBuffers(1, &instanceBuffer);
+    gl.bindBuffer(ARRAY_BUFFER, 0);
+    return true;
+}
+
+void CubeInstanceRenderer::markDirty() {
+    dirty = true;
+}
+
+bool CubeInstanceRenderer::hasFailed() const {
+    return failed;
+}
+
+bool CubeInstanceRenderer::draw(sf::RenderTarget& target, const std::vector<CubeInstance>& instances, float heightMultiplier,
+    const sf::Vector3f& thresholds, const CubePalette& palette) {
+    if (failed) {
+        return false;
+    }
+    if (!target.setActive(true)) {
+        // Without the target's context nothing can be drawn, the caller takes the vertex array path from now on
+        std::cerr << "Failed to activate the target for instanced cubes, falling back to vertex arrays" << std::endl;
+        failed = true;
+        return false;
+    }
+    if (!initialised) {
+        initialised = initialise();
+        failed = !initialised;
+        if (failed) {
+            return false;
+        }
+    }
+    if (instances.empty()) {
+        return true;
+    }
+
+    if (dirty) {
+        gl.bindBuffer(ARRAY_BUFFER, instanceBuffer);
+        gl.bufferData(ARRAY_BUFFER, static_cast<std::ptrdiff_t>(instances.size() * sizeof(CubeInstance)), instances.data(), STATIC_DRAW);
+        uploadedCount = instances.size();
+        dirty = false;
+    }
+
+    // SFML applies its view lazily, so the viewport is set here from the same view
+    const sf::IntRect viewport = target.getViewport(target.getView());
+    gl.viewport(viewport.left, static_cast<GLint>(target.getSize().y) - (viewport.top + viewport.height), viewport.width, viewport.height);
+
+    gl.useProgram(program);
+    gl.uniformMatrix4fv(uniforms.viewMatrix, 1, GL_FALSE, target.getView().getTransform().getMatrix());
+    gl.uniform2f(uniforms.isoStep, halfStep, quarterStep);
+    gl.uniform1f(uniforms.heightMultiplier, heightMultiplier);
+    gl.uniform3f(uniforms.thresholds, thresholds.x, thresholds.y, thresholds.z);
+    GLfloat topColors[CubePalette::CLASS_COUNT * 4];
+    GLfloat sideColors[CubePalette::CLASS_COUNT * 4];
+    for (int i = 0; i < CubePalette::CLASS_COUNT; i++) {
+        toFloats(palette.top[i], topColors + i * 4);
+        toFloats(palette.side[i], sideColors + i * 4);
+    }
+    gl.uniform4fv(uniforms.topColors, CubePalette::CLASS_COUNT, topColors);
+    gl.uniform4fv(uniforms.sideColors, CubePalette::CLASS_COUNT, sideColors);
+    GLfloat biomeTopColors[BIOME_COUNT * 4];
+    GLfloat biomeSideColors[BIOME_COUNT * 4];
+    for (int i = 0; i < BIOME_COUNT; i++) {
+        toFloats(palette.biomeTop[i], biomeTopColors + i * 4);
+        toFloats(palette.biomeSide[i], biomeSideColors + i * 4);
+    }
+    gl.uniform4fv(uniforms.biomeTopColors, BIOME_COUNT, biomeTopColors);
+    gl.uniform4fv(uniforms.biomeSideColors, BIOME_COUNT, biomeSideColors);
+
+    // No vertex array object, those are not shared between the window's and render textures' contexts
+    gl.bindBuffer(ARRAY_BUFFER, meshBuffer);
+    gl.enableVertexAttribArray(CORNER_ATTRIBUTE);
+    gl.vertexAttribPointer(CORNER_ATTRIBUTE, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), nullptr);
+
+    gl.bindBuffer(ARRAY_BUFFER, instanceBuffer);
+    const auto instanceAttribute = [](GLuint attribute, GLint size, GLenum type, GLboolean normalised, std::size_t offset) {
+        gl.enableVertexAttribArray(attribute);
+        gl.vertexAttribPointer(attribute, size, type, normalised, sizeof(CubeInstance), reinterpret_cast<const void*>(offset));
+        gl.vertexAttribDivisor(attribute, 1);
+    };
+    instanceAttribute(CELL_ATTRIBUTE, 2, GL_UNSIGNED_SHORT, GL_FALSE, offsetof(CubeInstance, x));
+    instanceAttribute(HEIGHT_ATTRIBUTE, 1, GL_UNSIGNED_SHORT, GL_TRUE, offsetof(CubeInstance, height));
+    instanceAttribute(BIOME_ATTRIBUTE, 1, GL_UNSIGNED_BYTE, GL_FALSE, offsetof(CubeInstance, biome));
+
+    // Instances are drawn in order, so cubes overlap exactly as the vertex array path draws them
+    gl.drawArraysInstanced(GL_TRIANGLES, 0, 18, static_cast<GLsizei>(uploadedCount));
+
+    // Leave the generic attributes as SFML expects them, attribute 0 aliases its vertex positions on some drivers
+    for (GLuint attribute : {CELL_ATTRIBUTE, HEIGHT_ATTRIBUTE, BIOME_ATTRIBUTE}) {
+        gl.vertexAttribDivisor(attribute, 0);
+        gl.disableVertexAttribArray(attribute);
+    }
+    gl.disableVertexAttribArray(CORNER_ATTRIBUTE);
+    gl.bindBuffer(ARRAY_BUFFER, 0);
+    gl.useProgram(0);
+    target.resetGLStates();
+    return true;
+}
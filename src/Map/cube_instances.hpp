@@ -0,0 +1,76 @@
+#ifndef MAP_CUBE_INSTANCES_HPP
+#define MAP_CUBE_INSTANCES_HPP
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+#include "biomes.hpp"
+
+// One terrain cube, expanded into its three visible faces by the vertex shader
+struct CubeInstance {
+    std::uint16_t x;
+    std::uint16_t y;
+    std::uint16_t height;     // noise value scaled to 0..65535, classified against the thresholds in the shader
+    Biome biome;
+    std::uint8_t padding;
+};
+static_assert(sizeof(CubeInstance) == 8, "cube instances are uploaded as tightly packed 8 byte records");
+
+struct CubePalette {
+    static constexpr int CLASS_COUNT = 4;
+    static constexpr int PLAINS_CLASS = 1;    // the class a biome recolours
+    sf::Color top[CLASS_COUNT];
+    sf::Color side[CLASS_COUNT];
+    sf::Color biomeTop[BIOME_COUNT];
+    sf::Color biomeSide[BIOME_COUNT];
+};
+
+// Draws isometric cubes from one CubeInstance per cell with instanced OpenGL, next to SFML's own
+// drawing. The 18 corners of the top, left and right faces are a shared static mesh; each instance
+// only adds its cell, height and biome. Needs GLSL 3.30 in the target's context (Mesa's
+// llvmpipe has it), draw() returns false when that is missing so the caller can fall back to sf::Vertex.
+class CubeInstanceRenderer {
+public:
+    // halfStep and quarterStep are the isometric offsets, the same ones the sf::Vertex path uses
+    CubeInstanceRenderer(float halfStep, float quarterStep);
+    CubeInstanceRenderer(const CubeInstanceRenderer&) = delete;
+    CubeInstanceRenderer& operator=(const CubeInstanceRenderer&) = delete;
+    ~CubeInstanceRenderer();
+
+    // The instances changed, they are uploaded again on the next draw
+    void markDirty();
+    // Main thread, with the target's view. Restores SFML's GL states before returning. Thresholds
+    // are the upper bounds of the first three palette classes
+    bool draw(sf::RenderTarget& target, const std::vector<CubeInstance>& instances, float heightMultiplier,
+        const sf::Vector3f& thresholds, const CubePalette& palette);
+    // Set once the GL setup or activating a target failed, it is not tried again
+    bool hasFailed() const;
+
+private:
+    float halfStep;
+    float quarterStep;
+    bool initialised = false;
+    bool failed = false;
+    bool dirty = true;
+    unsigned program = 0;
+    unsigned meshBuffer = 0;
+    unsigned instanceBuffer = 0;
+    std::size_t uploadedCount = 0;
+
+    // Looked up once after linking
+    struct UniformLocations {
+        int viewMatrix = -1;
+        int isoStep = -1;
+        int heightMultiplier = -1;
+        int thresholds = -1;
+        int topColors = -1;
+        int sideColors = -1;
+        int biomeTopColors = -1;
+        int biomeSideColors = -1;
+    };
+    UniformLocations uniforms;
+
+    bool initialise();
+};
+
+#endif // MAP_CUBE_INSTANCES_HPP
@@ -0,0 +1,63 @@
+#ifndef MAP_DOMAIN_WARP_HPP
+#define MAP_DOMAIN_WARP_HPP
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include "fused_noise.hpp"
+#include "../Utils/thread_pool.hpp"
+
+// Moves noise-space sample positions by two more fBm fields, so the terrain sampled there bends
+// into ridges and bays instead of round blobs. Both offsets come from one fused pass over the
+// lattice, the strength is in noise-space units, about the size of the largest features.
+class DomainWarp {
+public:
+    DomainWarp(std::shared_ptr<const NoiseState> offsetX, std::shared_ptr<const NoiseState> offsetY, double strength, int octaves)
+        : offsets({std::move(offsetX), std::move(offsetY)}), strength(strength), octaves({octaves, octaves}) {
+    }
+
+    // (x, y) moved by up to strength along each axis
+    void apply(double& x, double& y) const {
+        const FusedNoise<2>::Sample offset = offsets.octave2D_01(x, y, octaves);
+        x += strength * (offset[0] * 2 - 1);
+        y += strength * (offset[1] * 2 - 1);
+    }
+
+private:
+    FusedNoise<2> offsets;
+    double strength;
+    std::array<int, 2> octaves;
+};
+
+// Cells per side of a warped tile. A tile's heights and biomes are about 9 KB and stay in L1 with
+// the permutation tables while it is filled
+constexpr std::size_t WARP_TILE_SIZE = 32;
+
+// Samples noise at every cell (x, y) < (width, height) moved by warp, and passes the result to
+// store(x, y, sample). The offsets never leave registers: each cell is warped and sampled in one
+// go, tiles are spread over the pool
+template <std::size_t Channels, class Store>
+void fillWarpedTiles(const DomainWarp& warp, const FusedNoise<Channels>& noise, const std::array<int, Channels>& octaves,
+    float frequencyX, float frequencyY, std::size_t width, std::size_t height, Store store) {
+    const std::size_t tilesX = (width + WARP_TILE_SIZE - 1) / WARP_TILE_SIZE;
+    const std::size_t tilesY = (height + WARP_TILE_SIZE - 1) / WARP_TILE_SIZE;
+    ThreadPool::global().parallelFor(0, tilesX * tilesY, 1, [&](std::size_t first, std::size_t last) {
+        for (std::size_t tile = first; tile < last; ++tile) {
+            // Tiles run down the columns, so neighbouring tiles share the same column vectors
+            const std::size_t tileX = tile / tilesY * WARP_TILE_SIZE;
+            const std::size_t tileY = tile % tilesY * WARP_TILE_SIZE;
+            const std::size_t endX = std::min(tileX + WARP_TILE_SIZE, width);
+            const std::size_t endY = std::min(tileY + WARP_TILE_SIZE, height);
+            for (std::size_t x = tileX; x < endX; ++x) {
+                for (std::size_t y = tileY; y < endY; ++y) {
+                    double sampleX = x * frequencyX;
+                    double sampleY = y * frequencyY;
+                    warp.apply(sampleX, sampleY);
+                    store(x, y, noise.octave2D_01(sampleX, sampleY, octaves));
+                }
+            }
+        }
+    });
+}
+
+#endif // MAP_DOMAIN_WARP_HPP
@@ -0,0 +1,341 @@
+#include "edge_detect.hpp"
+#include "../Utils/thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+
+// Mirror without repeating the edge pixel, OpenCV's default border (BORDER_REFLECT_101)
+unsigned reflect(int index, unsigned size) {
+    if (index < 0) {
+        return static_cast<unsigned>(-index);
+    }
+    if (index >= static_cast<int>(size)) {
+        return 2 * size - 2 - static_cast<unsigned>(index);
+    }
+    return static_cast<unsigned>(index);
+}
+
+} // namespace
+
+EdgeContourExtractor::EdgeContourExtractor(EdgeDetectSettings settings) : settings(settings) {}
+
+unsigned EdgeContourExtractor::getBandCount(unsigned rows) const {
+    const unsigned threads = settings.threadCount > 0 ? settings.threadCount : ThreadPool::global().getThreadCount() + 1;
+    return std::max(1u, std::min(threads, rows / 16));
+}
+
+void EdgeContourExtractor::forEachBand(unsigned rows, const std::function<void(unsigned, unsigned, unsigned)>& work) const {
+    const unsigned bandCount = getBandCount(rows);
+    ThreadPool::global().parallelFor(0, bandCount, 1, [&](std::size_t firstBand, std::size_t lastBand) {
+        for (std::size_t band = firstBand; band < lastBand; ++band) {
+            const unsigned index = static_cast<unsigned>(band);
+            work(index, rows * index / bandCount, rows * (index + 1) / bandCount);
+        }
+    });
+}
+
+bool EdgeContourExtractor::extract(const sf::Image& image, ContourStore& store) {
+    const sf::Vector2u imageSize = image.getSize();
+    width = settings.size.x > 0 ? settings.size.x : imageSize.x;
+    height = settings.size.y > 0 ? settings.size.y : imageSize.y;
+    if (imageSize.x < 1 || imageSize.y < 1 || width < 3 || height < 3) {
+        std::cerr << "Image too small for edge detection" << std::endl;
+        return false;
+    }
+
+    sf::Clock clock;
+    convertToGray(image);
+    if (imageSize.x != width || imageSize.y != height) {
+        resample(imageSize.x, imageSize.y);
+    } else {
+        gray.swap(sourceGray);
+    }
+    gaussianBlur();
+    threshold(sobelMagnitude());
+    filterMs = clock.restart().asSeconds() * 1000.0f;
+
+    traceExternalBorders(store);
+    traceMs = clock.getElapsedTime().asSeconds() * 1000.0f;
+    return true;
+}
+
+void EdgeContourExtractor::convertToGray(const sf::Image& image) {
+    const sf::Vector2u imageSize = image.getSize();
+    const std::uint8_t* pixels = image.getPixelsPtr();
+    sourceGray.resize(static_cast<std::size_t>(imageSize.x) * imageSize.y);
+
+    // Rec. 601 luma in 14 bit fixed point, the weights cv::cvtColor uses
+    forEachBand(imageSize.y, [&](unsigned, unsigned firstRow, unsigned lastRow) {
+        const std::size_t begin = static_cast<std::size_t>(firstRow) * imageSize.x;
+        const std::size_t end = static_cast<std::size_t>(lastRow) * imageSize.x;
+        std::uint8_t* out = sourceGray.data();
+        for (std::size_t i = begin; i < end; ++i) {
+            const std::uint32_t r = pixels[i * 4], g = pixels[i * 4 + 1], b = pixels[i * 4 + 2];
+            out[i] = static_cast<std::uint8_t>((r * 4899 + g * 9617 + b * 1868 + 8192) >> 14);
+        }
+    });
+}
+
+void EdgeContourExtractor::resample(unsigned sourceWidth, unsigned sourceHeight) {
+    gray.resize(static_cast<std::size_t>(width) * height);
+
+    // Bilinear with pixel centres aligned, like cv::resize with INTER_LINEAR
+    const float scaleX = static_cast<float>(sourceWidth) / width;
+    const float scaleY = static_cast<float>(sourceHeight) / height;
+    std::vector<unsigned> left(width), right(width);
+    std::vector<float> weightX(width);
+    for (unsigned x = 0; x < width; ++x) {
+        const float sourceX = std::clamp((x + 0.5f) * scaleX - 0.5f, 0.0f, static_cast<float>(sourceWidth - 1));
+        left[x] = static_cast<unsigned>(sourceX);
+        right[x] = std::min(left[x] + 1, sourceWidth - 1);
+        weightX[x] = sourceX - left[x];
+    }
+
+    forEachBand(height, [&](unsigned, unsigned firstRow, unsigned lastRow) {
+        for (unsigned y = firstRow; y < lastRow; ++y) {
+            const float sourceY = std::clamp((y + 0.5f) * scaleY - 0.5f, 0.0f, static_cast<float>(sourceHeight - 1));
+            const unsigned top = static_cast<unsigned>(sourceY);
+            const unsigned bottom = std::min(top + 1, sourceHeight - 1);
+            const float weightY = sourceY - top;
+            const std::uint8_t* rowTop = sourceGray.data() + static_cast<std::size_t>(top) * sourceWidth;
+            const std::uint8_t* rowBottom = sourceGray.data() + static_cast<std::size_t>(bottom) * sourceWidth;
+            std::uint8_t* out = gray.data() + static_cast<std::size_t>(y) * width;
+            for (unsigned x = 0; x < width; ++x) {
+                const float upper = rowTop[left[x]] + (rowTop[right[x]] - rowTop[left[x]]) * weightX[x];
+                const float lower = rowBottom[left[x]] + (rowBottom[right[x]] - rowBottom[left[x]]) * weightX[x];
+                out[x] = static_cast<std::uint8_t>(upper + (lower - upper) * weightY + 0.5f);
+            }
+        }
+    });
+}
+
+void EdgeContourExtractor::gaussianBlur() {
+    const std::size_t pixelCount = static_cast<std::size_t>(width) * height;
+    rowBlur.resize(pixelCount);
+    blurred.resize(pixelCount);
+
+    // 3x3 Gaussian with sigma 0 is [1 2 1] / 4 on each axis, rows first
+    forEachBand(height, [&](unsigned, unsigned firstRow, unsigned lastRow) {
+        for (unsigned y = firstRow; y < lastRow; ++y) {
+            const std::uint8_t* in = gray.data() + static_cast<std::size_t>(y) * width;
+            std::uint16_t* out = rowBlur.data() + static_cast<std::size_t>(y) * width;
+            out[0] = static_cast<std::uint16_t>(in[1] + 2 * in[0] + in[1]);
+            for (unsigned x = 1; x + 1 < width; ++x) {
+                out[x] = static_cast<std::uint16_t>(in[x - 1] + 2 * in[x] + in[x + 1]);
+            }
+            out[width - 1] = static_cast<std::uint16_t>(in[width - 2] + 2 * in[width - 1] + in[width - 2]);
+        }
+    });
+
+    forEachBand(height, [&](unsigned, unsigned firstRow, unsigned lastRow) {
+        for (unsigned y = firstRow; y < lastRow; ++y) {
+            const std::uint16_t* above = rowBlur.data() + static_cast<std::size_t>(reflect(static_cast<int>(y) - 1, height)) * width;
+            const std::uint16_t* row = rowBlur.data() + static_cast<std::size_t>(y) * width;
+            const std::uint16_t* below = rowBlur.data() + static_cast<std::size_t>(reflect(static_cast<int>(y) + 1, height)) * width;
+            std::uint8_t* out = blurred.data() + static_cast<std::size_t>(y) * width;
+            for (unsigned x = 0; x < width; ++x) {
+                out[x] = static_cast<std::uint8_t>((above[x] + 2 * row[x] + below[x] + 8) >> 4);
+            }
+        }
+    });
+}
+
+float EdgeContourExtractor::sobelMagnitude() {
+    magnitude.resize(static_cast<std::size_t>(width) * height);
+    std::vector<float> bandMaximum(getBandCount(height), 0.0f);
+
+    forEachBand(height, [&](unsigned band, unsigned firstRow, unsigned lastRow) {
+        float maximum = 0.0f;
+        for (unsigned y = firstRow; y < lastRow; ++y) {
+            const std::uint8_t* above = blurred.data() + static_cast<std::size_t>(reflect(static_cast<int>(y) - 1, height)) * width;
+            const std::uint8_t* row = blurred.data() + static_cast<std::size_t>(y) * width;
+            const std::uint8_t* below = blurred.data() + static_cast<std::size_t>(reflect(static_cast<int>(y) + 1, height)) * width;
+            float* out = magnitude.data() + static_cast<std::size_t>(y) * width;
+
+            const auto gradient = [&](unsigned x, unsigned previous, unsigned next) {
+                const int gx = (above[next] - above[previous]) + 2 * (row[next] - row[previous]) + (below[next] - below[previous]);
+                const int gy = (below[previous] + 2 * below[x] + below[next]) - (above[previous] + 2 * above[x] + above[next]);
+                return std::sqrt(static_cast<float>(gx * gx + gy * gy));
+            };
+
+            out[0] = gradient(0, 1, 1);
+            for (unsigned x = 1; x + 1 < width; ++x) {
+                const int gx = (above[x + 1] - above[x - 1]) + 2 * (row[x + 1] - row[x - 1]) + (below[x + 1] - below[x - 1]);
+                const int gy = (below[x - 1] + 2 * below[x] + below[x + 1]) - (above[x - 1] + 2 * above[x] + above[x + 1]);
+                out[x] = std::sqrt(static_cast<float>(gx * gx + gy * gy));
+            }
+            out[width - 1] = gradient(width - 1, width - 2, width - 2);
+
+            for (unsigned x = 0; x < width; ++x) {
+                maximum = std::max(maximum, out[x]);
+            }
+        }
+        bandMaximum[band] = maximum;
+    });
+
+    return *std::max_element(bandMaximum.begin(), bandMaximum.end());
+}
+
+void EdgeContourExtractor::threshold(float maxMagnitude) {
+    mask.resize(static_cast<std::size_t>(width) * height);
+    const float scale = maxMagnitude > 0.0f ? 255.0f / maxMagnitude : 0.0f;
+    // Normalised to 0-255 and truncated like np.uint8, then compared like cv::threshold:
+    // floor(v) > threshold is v >= threshold + 1
+    const float limit = static_cast<float>(settings.threshold + 1);
+    forEachBand(height, [&](unsigned, unsigned firstRow, unsigned lastRow) {
+        const std::size_t begin = static_cast<std::size_t>(firstRow) * width;
+        const std::size_t end = static_cast<std::size_t>(lastRow) * width;
+        const float* in = magnitude.data();
+        std::uint8_t* out = mask.data();
+        for (std::size_t i = begin; i < end; ++i) {
+            out[i] = static_cast<std::uint8_t>(in[i] * scale >= limit);
+        }
+    });
+}
+
+void EdgeContourExtractor::traceExternalBorders(ContourStore& store) {
+    store.clear();
+
+    // Mask copied into a label image with a one pixel frame of background
+    const int stride = static_cast<int>(width) + 2;
+    labels.assign(static_cast<std::size_t>(stride) * (height + 2), 0);
+    for (unsigned y = 0; y < height; ++y) {
+        const std::uint8_t* in = mask.data() + static_cast<std::size_t>(y) * width;
+        int* out = labels.data() + static_cast<std::size_t>(y + 1) * stride + 1;
+        for (unsigned x = 0; x < width; ++x) {
+            out[x] = in[x];
+        }
+    }
+
+    // Neighbours counterclockwise on screen, starting east
+    const int offsets[8] = {1, -stride + 1, -stride, -stride - 1, -1, stride - 1, stride, stride + 1};
+
+    // Border 1 is the frame, which counts as a hole border
+    std::vector<char> isOuter = {0, 0};
+    std::vector<int> parents = {0, 0};
+    int* image = labels.data();
+    int border = 1;
+
+    const auto addPoint = [&store, stride](int pixel) {
+        store.addCoordinate(pixel % stride - 1);
+        store.addCoordinate(pixel / stride - 1);
+    };
+
+    for (int y = 1; y <= static_cast<int>(height); ++y) {
+        int lastBorder = 1;
+        for (int x = 1; x <= static_cast<int>(width); ++x) {
+            const int start = y * stride + x;
+            const int value = image[start];
+            if (value == 0) {
+                continue;
+            }
+
+            int fromDirection;
+            bool outer;
+            if (value == 1 && image[start - 1] == 0) {
+                outer = true;
+                fromDirection = 4;
+            } else if (value >= 1 && image[start + 1] == 0) {
+                outer = false;
+                fromDirection = 0;
+                if (value > 1) {
+                    lastBorder = value;
+                }
+            } else {
+                if (value != 1) {
+                    lastBorder = std::abs(value);
+                }
+                continue;
+            }
+
+            ++border;
+            const int parent = outer == static_cast<bool>(isOuter[lastBorder]) ? parents[lastBorder] : lastBorder;
+            isOuter.push_back(outer);
+            parents.push_back(parent);
+
+            // Only borders directly inside the frame are kept, like RETR_EXTERNAL
+            const bool keep = outer && parent == 1;
+            if (keep) {
+                store.beginContour();
+            }
+
+            // Clockwise from where we came for the first neighbour
+            int firstDirection = -1;
+            for (int k = 0; k < 8; ++k) {
+                const int direction = (fromDirection - k + 8) & 7;
+                if (image[start + offsets[direction]] != 0) {
+                    firstDirection = direction;
+                    break;
+                }
+            }
+
+            if (firstDirection < 0) {
+                // Isolated pixel
+                image[start] = -border;
+                if (keep) {
+                    addPoint(start);
+                }
+            } else {
+                const int first = start + offsets[firstDirection];
+                int current = start;
+                int backDirection = firstDirection;   // from current towards the previous pixel
+                int lastDirection = -1;
+                while (true) {
+                    // Counterclockwise from the previous pixel for the next one
+                    bool eastExamined = false;
+                    int direction = backDirection;
+                    for (int k = 1; k <= 8; ++k) {
+                        direction = (backDirection + k) & 7;
+                        if (image[current + offsets[direction]] != 0) {
+                            break;
+                        }
+                        eastExamined |= direction == 0;
+                    }
+                    const int next = current + offsets[direction];
+
+                    if (eastExamined) {
+                        image[current] = -border;
+                    } else if (image[current] == 1) {
+                        image[current] = border;
+                    }
+
+                    // Only the ends of straight runs are stored
+                    if (keep && direction != lastDirection) {
+                        addPoint(current);
+                    }
+                    lastDirection = direction;
+
+                    if (next == start && current == first) {
+                        break;
+                    }
+                    backDirection = (direction + 4) & 7;
+                    current = next;
+                }
+            }
+
+            if (image[start] != 1) {
+                lastBorder = std::abs(image[start]);
+            }
+        }
+    }
+
+    store.shrinkToFit();
+}
+
+const std::vector<std::uint8_t>& EdgeContourExtractor::getEdgeMask() const {
+    return mask;
+}
+
+sf::Vector2u EdgeContourExtractor::getMaskSize() const {
+    return sf::Vector2u(width, height);
+}
+
+float EdgeContourExtractor::getFilterMs() const {
+    return filterMs;
+}
+
+float EdgeContourExtractor::getTraceMs() const {
+    return traceMs;
+}
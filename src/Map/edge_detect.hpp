@@ -0,0 +1,59 @@
+#ifndef MAP_EDGE_DETECT_HPP
+#define MAP_EDGE_DETECT_HPP
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "contour_store.hpp"
+
+struct EdgeDetectSettings {
+    sf::Vector2u size = {1920, 1080};   // the image is resampled to this first, {0, 0} keeps its size
+    int threshold = 50;                 // on the gradient magnitude normalised to 0-255
+    unsigned threadCount = 0;           // 0 uses every pool thread and the caller
+};
+
+// Native version of scripts/utils/convert2BW.py: grayscale, 3x3 Gaussian blur, Sobel
+// magnitude, normalise, threshold, then the outermost borders of the edge mask traced
+// with Suzuki-Abe border following and reduced to direction changes (CHAIN_APPROX_SIMPLE).
+// The filters run over row bands in parallel with branch-free inner loops the compiler
+// can vectorise, the buffers are kept between calls.
+class EdgeContourExtractor {
+public:
+    explicit EdgeContourExtractor(EdgeDetectSettings settings = {});
+
+    // Replaces the contents of store, false if the image is too small to filter
+    bool extract(const sf::Image& image, ContourStore& store);
+
+    // Binary edge mask of the last extract(), one byte per pixel
+    const std::vector<std::uint8_t>& getEdgeMask() const;
+    sf::Vector2u getMaskSize() const;
+    float getFilterMs() const;
+    float getTraceMs() const;
+
+private:
+    EdgeDetectSettings settings;
+    unsigned width = 0;
+    unsigned height = 0;
+    std::vector<std::uint8_t> sourceGray;
+    std::vector<std::uint8_t> gray;
+    std::vector<std::uint16_t> rowBlur;
+    std::vector<std::uint8_t> blurred;
+    std::vector<float> magnitude;
+    std::vector<std::uint8_t> mask;
+    std::vector<int> labels;
+    float filterMs = 0.0f;
+    float traceMs = 0.0f;
+
+    void forEachBand(unsigned rows, const std::function<void(unsigned band, unsigned firstRow, unsigned lastRow)>& work) const;
+    unsigned getBandCount(unsigned rows) const;
+
+    void convertToGray(const sf::Image& image);
+    void resample(unsigned sourceWidth, unsigned sourceHeight);
+    void gaussianBlur();
+    float sobelMagnitude();
+    void threshold(float maxMagnitude);
+    void traceExternalBorders(ContourStore& store);
+};
+
+#endif // MAP_EDGE_DETECT_HPP
@@ -0,0 +1,51 @@
+#ifndef MAP_FUSED_NOISE_HPP
+#define MAP_FUSED_NOISE_HPP
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include "noise_cache.hpp"
+
+// fBm of several seeds at the same points in one pass. Each octave finds the lattice cell and fade
+// weights once and every channel only adds its own hashing and gradients, so extra channels cost
+// a fraction of another octave2D_01 pass. A channel can stop after fewer octaves than the others,
+// and gives exactly its NoiseState's octave2D_01 values for its own octave count.
+template <std::size_t Channels>
+class FusedNoise {
+public:
+    using Sample = std::array<double, Channels>;
+
+    explicit FusedNoise(std::array<std::shared_ptr<const NoiseState>, Channels> channels) : channels(std::move(channels)) {
+        for (std::size_t channel = 0; channel < Channels; ++channel) {
+            states[channel] = this->channels[channel].get();
+        }
+    }
+
+    // octave2D_01(x, y, octaves[c]) with persistence 0.5 for every channel c
+    Sample octave2D_01(double x, double y, const std::array<int, Channels>& octaves) const {
+        Sample result{};
+        double amplitude = 1;
+        const int octaveCount = *std::max_element(octaves.begin(), octaves.end());
+        for (int octave = 0; octave < octaveCount; ++octave) {
+            const NoiseState::Lattice lattice(x, y, static_cast<double>(SIVPERLIN_DEFAULT_Z));
+            for (std::size_t channel = 0; channel < Channels; ++channel) {
+                if (octave < octaves[channel]) {
+                    result[channel] += states[channel]->noise3D(lattice) * amplitude;
+                }
+            }
+            x *= 2;
+            y *= 2;
+            amplitude *= 0.5;
+        }
+        for (double& value : result) {
+            value = siv::perlin_detail::RemapClamp_01(value);
+        }
+        return result;
+    }
+
+private:
+    std::array<std::shared_ptr<const NoiseState>, Channels> channels;
+    const NoiseState* states[Channels];
+};
+
+#endif // MAP_FUSED_NOISE_HPP
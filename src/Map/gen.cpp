@@ -1,29 +1,186 @@
 #include "gen.hpp"
+#include "domain_warp.hpp"
+#include "../Utils/thread_pool.hpp"
+
+namespace {
+
+// Top and shadowed side colour of each terrain class, for both cube paths
+const CubePalette CUBE_PALETTE = {
+    {
+        sf::Color(0, 105, 148),     // Ocean Blue
+        sf::Color(34, 139, 34),     // Forest Green
+        sf::Color(205, 133, 63),    // Brown
+        sf::Color(220, 220, 220),   // Snow
+    },
+    {
+        sf::Color(0, 75, 105),
+        sf::Color(24, 100, 24),
+        sf::Color(139, 69, 19),
+        sf::Color(169, 169, 169),
+    },
+    // Plains by biome, in Biome order
+    {
+        sf::Color(34, 139, 34),     // None
+        sf::Color(150, 160, 140),   // Tundra
+        sf::Color(40, 90, 60),      // Taiga
+        sf::Color(110, 170, 60),    // Grassland
+        sf::Color(34, 139, 34),     // Forest
+        sf::Color(180, 170, 80),    // Savanna
+        sf::Color(220, 200, 130),   // Desert
+        sf::Color(20, 110, 50),     // Rainforest
+    },
+    {
+        sf::Color(24, 100, 24),
+        sf::Color(110, 118, 100),
+        sf::Color(28, 64, 42),
+        sf::Color(80, 125, 44),
+        sf::Color(24, 100, 24),
+        sf::Color(135, 125, 58),
+        sf::Color(170, 150, 95),
+        sf::Color(14, 80, 36),
+    },
+};
+
+// The colour the shaders pick, for meshes baked on the CPU
+sf::Color getPaletteColor(std::uint8_t terrainClass, Biome biome, bool side) {
+    if (terrainClass == CubePalette::PLAINS_CLASS && biome != Biome::None) {
+        const int index = static_cast<int>(biome);
+        return side ? CUBE_PALETTE.biomeSide[index] : CUBE_PALETTE.biomeTop[index];
+    }
+    return side ? CUBE_PALETTE.side[terrainClass] : CUBE_PALETTE.top[terrainClass];
+}
+
+} // namespace
 
 
 void LandmassGenerator::generateLandmass() {
-    grid.clear(); // Clear existing data before generating a new landmass
+    // Sized up front so columns can be filled in parallel, the noise itself is read only
+    grid.assign(GRID_WIDTH, std::vector<double>(GRID_HEIGHT));
 
+    // Shared with any other generation using the seed, the permutation is only shuffled once
     const siv::PerlinNoise::seed_type seed = settings.seedValue;
-    siv::PerlinNoise perlin(seed);
+    const std::shared_ptr<const NoiseState> noise = NoiseCache::global().get(seed);
 
-    for (int x = 0; x < GRID_WIDTH; ++x) {
-        std::vector<double> row;
-        for (int y = 0; y < GRID_HEIGHT; ++y) {
-            const double noise = perlin.octave2D_01(
-                x * settings.octaveMultiplierX, 
-                y * settings.octaveMultiplierY, 
-                settings.octaves
-            );
-            row.push_back(noise);
+    if (settings.warpStrength > 0.0f) {
+        // Warp offsets and the noise at the warped position per cell, tile by tile. Biomes are
+        // sampled at the same warped position, so they follow the coastlines
+        const DomainWarp warp(NoiseCache::global().get(deriveNoiseSeed(seed, NoiseChannel::WarpX)),
+            NoiseCache::global().get(deriveNoiseSeed(seed, NoiseChannel::WarpY)), settings.warpStrength, settings.warpOctaves);
+        if (settings.drawBiomes) {
+            const FusedNoise<3> fused({noise, NoiseCache::global().get(deriveNoiseSeed(seed, NoiseChannel::Moisture)),
+                NoiseCache::global().get(deriveNoiseSeed(seed, NoiseChannel::Temperature))});
+            biomes.assign(GRID_WIDTH, std::vector<Biome>(GRID_HEIGHT));
+            fillWarpedTiles(warp, fused, {settings.octaves, BIOME_OCTAVES, BIOME_OCTAVES}, settings.octaveMultiplierX, settings.octaveMultiplierY,
+                GRID_WIDTH, GRID_HEIGHT, [&](std::size_t x, std::size_t y, const FusedNoise<3>::Sample& sample) {
+                    grid[x][y] = sample[0];
+                    biomes[x][y] = classifyBiome(sample[0], sample[1], sample[2]);
+                });
+        } else {
+            biomes.clear();
+            biomes.shrink_to_fit();
+            const FusedNoise<1> fused({noise});
+            fillWarpedTiles(warp, fused, {settings.octaves}, settings.octaveMultiplierX, settings.octaveMultiplierY,
+                GRID_WIDTH, GRID_HEIGHT, [&](std::size_t x, std::size_t y, const FusedNoise<1>::Sample& sample) {
+                    grid[x][y] = sample[0];
+                });
         }
-        grid.push_back(row);
+    } else if (settings.drawBiomes) {
+        // Height, moisture and temperature in one pass over the shared lattice, the height is the
+        // same as without biomes
+        const FusedNoise<3> fused({noise, NoiseCache::global().get(deriveNoiseSeed(seed, NoiseChannel::Moisture)),
+            NoiseCache::global().get(deriveNoiseSeed(seed, NoiseChannel::Temperature))});
+        const std::array<int, 3> octaves = {settings.octaves, BIOME_OCTAVES, BIOME_OCTAVES};
+        biomes.assign(GRID_WIDTH, std::vector<Biome>(GRID_HEIGHT));
+        ThreadPool::global().parallelFor(0, GRID_WIDTH, 8, [&](std::size_t first, std::size_t last) {
+            for (std::size_t x = first; x < last; ++x) {
+                for (int y = 0; y < GRID_HEIGHT; ++y) {
+                    const double sampleX = x * settings.octaveMultiplierX;
+                    const double sampleY = y * settings.octaveMultiplierY;
+                    const FusedNoise<3>::Sample sample = fused.octave2D_01(sampleX, sampleY, octaves);
+                    grid[x][y] = sample[0];
+                    biomes[x][y] = classifyBiome(sample[0], sample[1], sample[2]);
+                }
+            }
+        });
+    } else {
+        biomes.clear();
+        biomes.shrink_to_fit();
+        // Unrolled for the common octave counts, the same values as the octave loop
+        const NoiseColumnKernel fillColumns = selectNoiseKernel(settings.octaves);
+        ThreadPool::global().parallelFor(0, GRID_WIDTH, 8, [&](std::size_t first, std::size_t last) {
+            fillColumns(*noise, settings.octaveMultiplierX, settings.octaveMultiplierY, settings.octaves, grid, first, last);
+        });
     }
 
     previousSettings = settings; // Update previous settings
-    cacheColors();
     rebuildVertexArray();
-    
+    rebuildIsolines();
+}
+
+void LandmassGenerator::reportMemory(MemoryRegistry& registry) const {
+    registry.report("terrain.heightfield", measureMemory(grid));
+    registry.report("terrain.biomes", measureMemory(biomes));
+    registry.report("terrain.colours", measureMemory(cachedColors));
+    registry.report("terrain.vertices", {vertexArray.getVertexCount() * sizeof(sf::Vertex), vertexArray.getVertexCount() > 0 ? 1u : 0u});
+    registry.report("terrain.instances", measureMemory(cubeInstances));
+    isolineLayer.reportMemory(registry, "terrain.isolines");
+}
+
+std::vector<std::pair<std::string, float>> getLandmassSettingValues(const LandmassSettings& settings) {
+    return {
+        {"octaveMultiplierX", settings.octaveMultiplierX},
+        {"octaveMultiplierY", settings.octaveMultiplierY},
+        {"octaves", static_cast<float>(settings.octaves)},
+        {"seedValue", static_cast<float>(settings.seedValue)},
+        {"waterThreshold", settings.waterThreshold},
+        {"plainsThreshold", settings.plainsThreshold},
+        {"hillsThreshold", settings.hillsThreshold},
+        {"cubeHeightMultiplier", settings.cubeHeightMultiplier},
+        {"drawGrid", settings.drawGrid ? 1.0f : 0.0f},
+        {"drawCubes", settings.drawCubes ? 1.0f : 0.0f},
+        {"instancedCubes", settings.instancedCubes ? 1.0f : 0.0f},
+        {"drawBiomes", settings.drawBiomes ? 1.0f : 0.0f},
+        {"warpStrength", settings.warpStrength},
+        {"warpOctaves", static_cast<float>(settings.warpOctaves)},
+        {"drawIsolines", settings.drawIsolines ? 1.0f : 0.0f},
+    };
+}
+
+bool setLandmassSettingValue(LandmassSettings& settings, const std::string& name, float value) {
+    if (name == "octaveMultiplierX") {
+        settings.octaveMultiplierX = value;
+    } else if (name == "octaveMultiplierY") {
+        settings.octaveMultiplierY = value;
+    } else if (name == "octaves") {
+        settings.octaves = static_cast<int>(value);
+    } else if (name == "seedValue") {
+        settings.seedValue = static_cast<int>(value);
+    } else if (name == "waterThreshold") {
+        settings.waterThreshold = value;
+    } else if (name == "plainsThreshold") {
+        settings.plainsThreshold = value;
+    } else if (name == "hillsThreshold") {
+        settings.hillsThreshold = value;
+    } else if (name == "cubeHeightMultiplier") {
+        settings.cubeHeightMultiplier = value;
+    } else if (name == "drawGrid") {
+        settings.drawGrid = value != 0.0f;
+    } else if (name == "drawCubes") {
+        settings.drawCubes = value != 0.0f;
+    } else if (name == "instancedCubes") {
+        settings.instancedCubes = value != 0.0f;
+    } else if (name == "drawBiomes") {
+        settings.drawBiomes = value != 0.0f;
+    } else if (name == "warpStrength") {
+        settings.warpStrength = value;
+    } else if (name == "warpOctaves") {
+        settings.warpOctaves = static_cast<int>(value);
+    } else if (name == "drawIsolines") {
+        settings.drawIsolines = value != 0.0f;
+    } else {
+        return false;
+    }
+    return true;
 }
 
 LandmassGenerator::LandmassGenerator(LandmassSettings settings) : settings(settings), previousSettings(settings) {
@@ -31,109 +188,267 @@ LandmassGenerator::LandmassGenerator(LandmassSettings settings) : settings(setti
 }
 
 
+bool LandmassGenerator::useInstancedCubes() const {
+    return settings.drawCubes && settings.instancedCubes && !cubeRenderer.hasFailed();
+}
+
+sf::Vector3f LandmassGenerator::getThresholds() const {
+    return sf::Vector3f(settings.waterThreshold, settings.plainsThreshold, settings.hillsThreshold);
+}
+
+Biome LandmassGenerator::getBiome(int x, int y) const {
+    return biomes.empty() ? Biome::None : biomes[x][y];
+}
+
+std::uint8_t LandmassGenerator::getTerrainClass(double noiseValue) const {
+    if (noiseValue < settings.waterThreshold) {
+        return 0;
+    } else if (noiseValue < settings.plainsThreshold) {
+        return 1;
+    } else if (noiseValue < settings.hillsThreshold) {
+        return 2;
+    }
+    return 3;
+}
+
 void LandmassGenerator::rebuildVertexArray() {
     vertexArray.clear();
     vertexArray.setPrimitiveType(sf::Quads);
 
-    if (settings.drawCubes) {
-        vertexArray.resize(GRID_WIDTH * GRID_HEIGHT * 12); // Allocate space for cubes
-        for (int x = 0; x < GRID_WIDTH; ++x) {
-            for (int y = 0; y < GRID_HEIGHT; ++y) {
-                addCubeVertices(x, y);
+    if (useInstancedCubes()) {
+        // 8 bytes per cell instead of 12 vertices, the renderer uploads them on the next draw
+        cachedColors.clear();
+        cubeInstances.resize(static_cast<std::size_t>(GRID_WIDTH) * GRID_HEIGHT);
+        ThreadPool::global().parallelFor(0, GRID_WIDTH, 8, [&](std::size_t first, std::size_t last) {
+            for (std::size_t x = first; x < last; ++x) {
+                for (int y = 0; y < GRID_HEIGHT; ++y) {
+                    const double noiseValue = grid[x][y];
+                    CubeInstance& instance = cubeInstances[x * GRID_HEIGHT + y];
+                    instance.x = static_cast<std::uint16_t>(x);
+                    instance.y = static_cast<std::uint16_t>(y);
+                    instance.height = static_cast<std::uint16_t>(std::clamp(noiseValue, 0.0, 1.0) * 65535.0 + 0.5);
+                    instance.biome = getBiome(static_cast<int>(x), y);
+                    instance.padding = 0;
+                }
             }
-        }
+        });
+        cubeRenderer.markDirty();
+        return;
+    }
+    cubeInstances.clear();
+    cubeInstances.shrink_to_fit();
+
+    // Baked tiles take their colour from the cache, shaded ones work it out from the height
+    if (shadedTerrain || settings.drawCubes) {
+        cachedColors.clear();
     } else {
-        vertexArray.resize(GRID_WIDTH * GRID_HEIGHT * 4); // Allocate space for flat tiles
-        for (int x = 0; x < GRID_WIDTH; ++x) {
+        cacheColors();
+    }
+
+    // Every cell owns a fixed run of vertices, so columns are meshed in parallel
+    const std::size_t cellVertices = settings.drawCubes ? 12 : 4;
+    vertexArray.resize(GRID_WIDTH * GRID_HEIGHT * cellVertices);
+    ThreadPool::global().parallelFor(0, GRID_WIDTH, 8, [&](std::size_t first, std::size_t last) {
+        for (std::size_t x = first; x < last; ++x) {
             for (int y = 0; y < GRID_HEIGHT; ++y) {
-                addTileVertices(x, y);
+                sf::Vertex* vertices = &vertexArray[(x * GRID_HEIGHT + y) * cellVertices];
+                if (settings.drawCubes) {
+                    addCubeVertices(static_cast<int>(x), y, vertices);
+                } else {
+                    addTileVertices(static_cast<int>(x), y, vertices);
+                }
             }
         }
-    }
+    });
 }
 
 
-void LandmassGenerator::addCubeVertices(int x, int y) {
+void LandmassGenerator::addCubeVertices(int x, int y, sf::Vertex* vertices) const {
     // Get noise-based elevation and position in isometric view
     double noiseValue = grid[x][y];
-    float cubeHeight = noiseValue * settings.cubeHeightMultiplier;
+    const Biome biome = getBiome(x, y);
     float isoX = (x - y) * (SCALE / 2);
     float isoY = (x + y) * (SCALE / 4);
 
-    // Define colors based on terrain type
-    sf::Color topColor, sideColor;
-    if (noiseValue < settings.waterThreshold) {
-        topColor = sf::Color(0, 105, 148);  // Ocean Blue
-        sideColor = sf::Color(0, 75, 105);  // Shadowed side
-    } else if (noiseValue < settings.plainsThreshold) {
-        topColor = sf::Color(34, 139, 34);  // Forest Green
-        sideColor = sf::Color(24, 100, 24);
-    } else if (noiseValue < settings.hillsThreshold) {
-        topColor = sf::Color(205, 133, 63); // Brown
-        sideColor = sf::Color(139, 69, 19);
-    } else {
-        topColor = sf::Color(220, 220, 220); // Snow
-        sideColor = sf::Color(169, 169, 169);
-    }
-
-    // Define top face vertices
-    sf::Vector2f topLeft(isoX, isoY - cubeHeight);
-    sf::Vector2f topRight(isoX + SCALE / 2, isoY - SCALE / 4 - cubeHeight);
-    sf::Vector2f bottomLeft(isoX - SCALE / 2, isoY - SCALE / 4 - cubeHeight);
-    sf::Vector2f bottomRight(isoX, isoY - SCALE / 2 - cubeHeight);
+    // Top face corners at height 0, raised corners are lifted by the cube height
+    sf::Vector2f topLeft(isoX, isoY);
+    sf::Vector2f topRight(isoX + SCALE / 2, isoY - SCALE / 4);
+    sf::Vector2f bottomLeft(isoX - SCALE / 2, isoY - SCALE / 4);
+    sf::Vector2f bottomRight(isoX, isoY - SCALE / 2);
 
     // Add top face vertices
-    vertexArray.append(sf::Vertex(topLeft, topColor));
-    vertexArray.append(sf::Vertex(topRight, topColor));
-    vertexArray.append(sf::Vertex(bottomRight, topColor));
-    vertexArray.append(sf::Vertex(bottomLeft, topColor));
+    const TerrainShader::Face top = TerrainShader::Face::Top;
+    vertices[0] = makeCubeVertex(topLeft, noiseValue, biome, true, top);
+    vertices[1] = makeCubeVertex(topRight, noiseValue, biome, true, top);
+    vertices[2] = makeCubeVertex(bottomRight, noiseValue, biome, true, top);
+    vertices[3] = makeCubeVertex(bottomLeft, noiseValue, biome, true, top);
 
     // Left face
-    vertexArray.append(sf::Vertex(bottomLeft, sideColor));
-    vertexArray.append(sf::Vertex(sf::Vector2f(bottomLeft.x, bottomLeft.y + cubeHeight), sideColor));
-    vertexArray.append(sf::Vertex(sf::Vector2f(topLeft.x, topLeft.y + cubeHeight), sideColor));
-    vertexArray.append(sf::Vertex(topLeft, sideColor));
+    const TerrainShader::Face side = TerrainShader::Face::Side;
+    vertices[4] = makeCubeVertex(bottomLeft, noiseValue, biome, true, side);
+    vertices[5] = makeCubeVertex(bottomLeft, noiseValue, biome, false, side);
+    vertices[6] = makeCubeVertex(topLeft, noiseValue, biome, false, side);
+    vertices[7] = makeCubeVertex(topLeft, noiseValue, biome, true, side);
 
     // Right face
-    vertexArray.append(sf::Vertex(bottomRight, sideColor));
-    vertexArray.append(sf::Vertex(sf::Vector2f(bottomRight.x, bottomRight.y + cubeHeight), sideColor));
-    vertexArray.append(sf::Vertex(sf::Vector2f(topRight.x, topRight.y + cubeHeight), sideColor));
-    vertexArray.append(sf::Vertex(topRight, sideColor));
+    vertices[8] = makeCubeVertex(bottomRight, noiseValue, biome, true, side);
+    vertices[9] = makeCubeVertex(bottomRight, noiseValue, biome, false, side);
+    vertices[10] = makeCubeVertex(topRight, noiseValue, biome, false, side);
+    vertices[11] = makeCubeVertex(topRight, noiseValue, biome, true, side);
 }
 
-void LandmassGenerator::addTileVertices(int x, int y) {
-    sf::Color tileColor = cachedColors[x][y];
+sf::Vertex LandmassGenerator::makeCubeVertex(const sf::Vector2f& basePosition, double noiseValue, Biome biome, bool raised, TerrainShader::Face face) const {
+    if (shadedTerrain) {
+        return TerrainShader::makeVertex(basePosition, noiseValue, raised, face, biome);
+    }
+    const float cubeHeight = raised ? static_cast<float>(noiseValue * settings.cubeHeightMultiplier) : 0.0f;
+    const sf::Color color = getPaletteColor(getTerrainClass(noiseValue), biome, face == TerrainShader::Face::Side);
+    return sf::Vertex(sf::Vector2f(basePosition.x, basePosition.y - cubeHeight), color);
+}
+
+void LandmassGenerator::addTileVertices(int x, int y, sf::Vertex* vertices) const {
     float posX = x * SCALE;
     float posY = y * SCALE;
 
-    vertexArray.append(sf::Vertex(sf::Vector2f(posX, posY), tileColor));
-    vertexArray.append(sf::Vertex(sf::Vector2f(posX + SCALE, posY), tileColor));
-    vertexArray.append(sf::Vertex(sf::Vector2f(posX + SCALE, posY + SCALE), tileColor));
-    vertexArray.append(sf::Vertex(sf::Vector2f(posX, posY + SCALE), tileColor));
+    if (shadedTerrain) {
+        const double noiseValue = grid[x][y];
+        const Biome biome = getBiome(x, y);
+        const TerrainShader::Face tile = TerrainShader::Face::Tile;
+        vertices[0] = TerrainShader::makeVertex(sf::Vector2f(posX, posY), noiseValue, false, tile, biome);
+        vertices[1] = TerrainShader::makeVertex(sf::Vector2f(posX + SCALE, posY), noiseValue, false, tile, biome);
+        vertices[2] = TerrainShader::makeVertex(sf::Vector2f(posX + SCALE, posY + SCALE), noiseValue, false, tile, biome);
+        vertices[3] = TerrainShader::makeVertex(sf::Vector2f(posX, posY + SCALE), noiseValue, false, tile, biome);
+        return;
+    }
+
+    sf::Color tileColor = cachedColors[x][y];
+
+    vertices[0] = sf::Vertex(sf::Vector2f(posX, posY), tileColor);
+    vertices[1] = sf::Vertex(sf::Vector2f(posX + SCALE, posY), tileColor);
+    vertices[2] = sf::Vertex(sf::Vector2f(posX + SCALE, posY + SCALE), tileColor);
+    vertices[3] = sf::Vertex(sf::Vector2f(posX, posY + SCALE), tileColor);
 }
 
-void LandmassGenerator::draw(sf::RenderWindow& window) {
-    if (settings.cubeHeightMultiplier != previousSettings.cubeHeightMultiplier 
-        || settings.drawCubes != previousSettings.drawCubes
-        || settings.octaveMultiplierX != previousSettings.octaveMultiplierX
+bool LandmassGenerator::update() {
+    bool changed = isolineColorChanged || settings.drawGrid != previousSettings.drawGrid;
+    isolineColorChanged = false;
+
+    if (settings.octaveMultiplierX != previousSettings.octaveMultiplierX
         || settings.octaveMultiplierY != previousSettings.octaveMultiplierY
         || settings.octaves != previousSettings.octaves
         || settings.seedValue != previousSettings.seedValue
+        || settings.drawBiomes != previousSettings.drawBiomes
+        || settings.warpStrength != previousSettings.warpStrength
+        || settings.warpOctaves != previousSettings.warpOctaves
+    ) {
+        generateLandmass();
+        previousSettings = settings; // Update previousSettings here
+        changed = true;
+    } else if (settings.drawCubes != previousSettings.drawCubes
+        || settings.instancedCubes != previousSettings.instancedCubes
+    ) {
+        // The heightfield is unchanged, the mesh changes shape
+        previousSettings = settings;
+        rebuildVertexArray();
+        rebuildIsolines();
+        changed = true;
+    } else if (settings.cubeHeightMultiplier != previousSettings.cubeHeightMultiplier
         || settings.waterThreshold != previousSettings.waterThreshold
         || settings.plainsThreshold != previousSettings.plainsThreshold
         || settings.hillsThreshold != previousSettings.hillsThreshold
+        || settings.drawIsolines != previousSettings.drawIsolines
     ) {
-        generateLandmass();
-        previousSettings = settings; // Update previousSettings here
+        // Colours and heights are shader uniforms, the mesh only follows them when they are baked in
+        previousSettings = settings;
+        if (!shadedTerrain && !useInstancedCubes()) {
+            rebuildVertexArray();
+        }
+        rebuildIsolines();
+        changed = true;
+    }
+    previousSettings.drawGrid = settings.drawGrid;
+    return changed;
+}
+
+void LandmassGenerator::draw(sf::RenderTarget& target) {
+    update();
+
+    if (useInstancedCubes()
+        && !cubeRenderer.draw(target, cubeInstances, settings.cubeHeightMultiplier, getThresholds(), CUBE_PALETTE)) {
+        // No OpenGL 3.3 or no usable context, build the vertex array this frame and stay on it
+        rebuildVertexArray();
+    }
+    if (!useInstancedCubes()) {
+        if (shadedTerrain && !terrainShader.load()) {
+            // No shaders at all, bake heights and colours into the vertices from now on
+            shadedTerrain = false;
+            rebuildVertexArray();
+        }
+        if (shadedTerrain) {
+            terrainShader.setStyle(settings.cubeHeightMultiplier, getThresholds(), CUBE_PALETTE);
+            target.draw(vertexArray, terrainShader.getShader());
+        } else {
+            target.draw(vertexArray);
+        }
     }
 
-    window.draw(vertexArray);
+    if (settings.drawIsolines) {
+        isolineLayer.draw(target, 1.0f);
+    }
 
     if (settings.drawGrid) {
-        drawGrid(window);
+        drawGrid(target);
     }
 }
 
+void LandmassGenerator::rebuildIsolines() {
+    if (!settings.drawIsolines) {
+        return;
+    }
+
+    sf::Clock clock;
+    std::vector<Isoline> isolines = isolineExtractor.extract(grid, {
+        settings.waterThreshold,
+        settings.plainsThreshold,
+        settings.hillsThreshold
+    });
+    for (auto& isoline : isolines) {
+        for (auto& point : isoline.points) {
+            point = projectGridPoint(point, isoline.level);
+        }
+    }
+    isolineLayer.setIsolines(isolines);
+    isolineCount = isolines.size();
+    isolineBuildMs = clock.getElapsedTime().asSeconds() * 1000.0f;
+}
+
+sf::Vector2f LandmassGenerator::projectGridPoint(const sf::Vector2f& point, double level) const {
+    if (settings.drawCubes) {
+        // Centre of the cube's top face at the isoline's height, same projection as addCubeVertices
+        const float height = static_cast<float>(level * settings.cubeHeightMultiplier);
+        return sf::Vector2f((point.x - point.y) * (SCALE / 2),
+                            (point.x + point.y) * (SCALE / 4) - SCALE / 4 - height);
+    }
+    // Centre of the flat tile
+    return sf::Vector2f(point.x * SCALE + SCALE / 2.0f, point.y * SCALE + SCALE / 2.0f);
+}
+
+void LandmassGenerator::setIsolineColor(const sf::Color& color) {
+    if (color != isolineColor) {
+        isolineColor = color;
+        isolineColorChanged = settings.drawIsolines;
+    }
+    isolineLayer.changeColor(color);
+}
+
+std::size_t LandmassGenerator::getIsolineCount() const {
+    return isolineCount;
+}
+
+float LandmassGenerator::getIsolineBuildMs() const {
+    return isolineBuildMs;
+}
+
 
 void LandmassGenerator::cacheColors() {
     cachedColors.clear();
@@ -146,7 +461,7 @@ void LandmassGenerator::cacheColors() {
             if (noiseValue < settings.waterThreshold) {
                 tileColor = sf::Color(0, 105, 148);  // Ocean Blue
             } else if (noiseValue < settings.plainsThreshold) {
-                tileColor = sf::Color(34, 139, 34);  // Forest Green
+                tileColor = getPaletteColor(CubePalette::PLAINS_CLASS, getBiome(x, y), false);  // Forest Green without biomes
             } else if (noiseValue < settings.hillsThreshold) {
                 tileColor = sf::Color(205, 133, 63); // Earthy Brown
             } else {
@@ -166,7 +481,7 @@ void LandmassGenerator::cacheColors() {
 }
 
 
-void LandmassGenerator::drawGrid(sf::RenderWindow& window) {
+void LandmassGenerator::drawGrid(sf::RenderTarget& target) {
     // Use vertex array for grid to reduce individual draw calls
     sf::VertexArray gridLines(sf::Lines);
 
@@ -182,5 +497,5 @@ void LandmassGenerator::drawGrid(sf::RenderWindow& window) {
         gridLines.append(sf::Vertex(sf::Vector2f(GRID_WIDTH * SCALE, y * SCALE), sf::Color(50, 50, 50, 100)));
     }
 
-    window.draw(gridLines);
+    target.draw(gridLines);
 }
\ No newline at end of file
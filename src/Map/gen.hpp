@@ -7,6 +7,13 @@
 #include <PerlinNoise.hpp>
 #include <iostream>
 #include "../Camera/controller.hpp"
+#include "biomes.hpp"
+#include "contours.hpp"
+#include "cube_instances.hpp"
+#include "isolines.hpp"
+#include "terrain_noise.hpp"
+#include "terrain_shader.hpp"
+#include "../Utils/memory_registry.hpp"
 
 struct LandmassSettings {
     float octaveMultiplierX = 0.06;
@@ -19,28 +26,68 @@ struct LandmassSettings {
     float cubeHeightMultiplier = 22.33;
     bool drawGrid = false;
     bool drawCubes = true;
+    bool instancedCubes = false;   // one 8 byte instance per cube, expanded on the GPU
+    bool drawBiomes = false;       // recolour the plains from moisture and temperature noise
+    float warpStrength = 0.0f;     // domain warp in noise-space units, 0 for none
+    int warpOctaves = 4;
+    bool drawIsolines = false;
 };
 
+// Settings by name, so changes can be recorded and replayed
+std::vector<std::pair<std::string, float>> getLandmassSettingValues(const LandmassSettings& settings);
+bool setLandmassSettingValue(LandmassSettings& settings, const std::string& name, float value);
+
 class LandmassGenerator {
 public:
     void generateLandmass();
     LandmassGenerator(LandmassSettings settings);
-    void draw(sf::RenderWindow& window);
+    // Applies changed settings, true when the next draw will look different
+    bool update();
+    void draw(sf::RenderTarget& target);
     LandmassSettings settings;
+    void setIsolineColor(const sf::Color& color);
+    std::size_t getIsolineCount() const;
+    float getIsolineBuildMs() const;
+    // Heightfield, colour cache, vertices and isolines under "terrain"
+    void reportMemory(MemoryRegistry& registry) const;
 private:
     const int SCALE = 5;
     const int GRID_WIDTH = 1920 / SCALE;
     const int GRID_HEIGHT = 1080 / SCALE;
     std::vector<std::vector<double>> grid;
+    // Empty while biomes are off
+    std::vector<std::vector<Biome>> biomes;
+    // Moisture and temperature only decide a colour, they stop well before the height's octaves
+    const int BIOME_OCTAVES = 6;
     LandmassSettings previousSettings;
     sf::VertexArray vertexArray;
+    std::vector<CubeInstance> cubeInstances;
+    CubeInstanceRenderer cubeRenderer{static_cast<float>(SCALE / 2), static_cast<float>(SCALE / 4)};
+    TerrainShader terrainShader;
+    // Vertices hold raw heights for the terrain shader, until drawing finds shaders unavailable
+    bool shadedTerrain = true;
     std::vector<std::vector<sf::Color>> cachedColors;
-    void drawGrid(sf::RenderWindow& window);
+    IsolineExtractor isolineExtractor;
+    Contours isolineLayer{""};
+    std::size_t isolineCount = 0;
+    float isolineBuildMs = 0.0f;
+    sf::Color isolineColor;
+    bool isolineColorChanged = false;
+    void drawGrid(sf::RenderTarget& target);
     void rebuildVertexArray();
     void makeTile(int x, int y, sf::RenderWindow& window);
-    void addCubeVertices(int x, int y);
-    void addTileVertices(int x, int y);
+    void addCubeVertices(int x, int y, sf::Vertex* vertices) const;
+    void addTileVertices(int x, int y, sf::Vertex* vertices) const;
+    // A cube corner at height 0 for the shader, or with its height and colour baked in
+    sf::Vertex makeCubeVertex(const sf::Vector2f& basePosition, double noiseValue, Biome biome, bool raised, TerrainShader::Face face) const;
+    Biome getBiome(int x, int y) const;
+    // Index into the cube palette for a noise value
+    std::uint8_t getTerrainClass(double noiseValue) const;
+    bool useInstancedCubes() const;
+    sf::Vector3f getThresholds() const;
     void cacheColors();
+    void rebuildIsolines();
+    sf::Vector2f projectGridPoint(const sf::Vector2f& point, double level) const;
 };
 
 #endif
@@ -0,0 +1,102 @@
+#include "geometry_store.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+GeometryStore::GeometryStore(double quantum) : quantum(quantum) {}
+
+std::int64_t GeometryStore::quantise(double value) const {
+    return std::llround(value / quantum);
+}
+
+void GeometryStore::beginFeature(double originX, double originY) {
+    origins.push_back({quantise(originX), quantise(originY)});
+}
+
+void GeometryStore::pushDelta(std::int64_t delta) {
+    std::uint64_t zigzag = (static_cast<std::uint64_t>(delta) << 1) ^ static_cast<std::uint64_t>(delta >> 63);
+    while (zigzag >= 0x80) {
+        stream.push_back(static_cast<std::uint8_t>(zigzag | 0x80));
+        zigzag >>= 7;
+    }
+    stream.push_back(static_cast<std::uint8_t>(zigzag));
+}
+
+std::size_t GeometryStore::addRing(const double* xy, std::size_t pointCount) {
+    if (pointCount == 0) {
+        return addEmptyRing();
+    }
+
+    std::int64_t x = quantise(xy[0]);
+    std::int64_t y = quantise(xy[1]);
+
+    // Open a new origin when there is none yet or the first point is out of int32 reach
+    const std::int64_t limit = std::numeric_limits<std::int32_t>::max();
+    if (origins.empty()
+        || std::llabs(x - origins.back().x) > limit
+        || std::llabs(y - origins.back().y) > limit) {
+        origins.push_back({x, y});
+    }
+    const Origin& origin = origins.back();
+
+    Ring ring;
+    ring.streamOffset = static_cast<std::uint32_t>(stream.size());
+    ring.pointCount = static_cast<std::uint32_t>(pointCount);
+    ring.firstX = static_cast<std::int32_t>(x - origin.x);
+    ring.firstY = static_cast<std::int32_t>(y - origin.y);
+    ring.origin = static_cast<std::uint32_t>(origins.size() - 1);
+
+    for (std::size_t i = 1; i < pointCount; ++i) {
+        const std::int64_t nextX = quantise(xy[i * 2]);
+        const std::int64_t nextY = quantise(xy[i * 2 + 1]);
+        pushDelta(nextX - x);
+        pushDelta(nextY - y);
+        x = nextX;
+        y = nextY;
+    }
+
+    rings.push_back(ring);
+    totalPoints += pointCount;
+    return rings.size() - 1;
+}
+
+std::size_t GeometryStore::addEmptyRing() {
+    rings.push_back({static_cast<std::uint32_t>(stream.size()), 0, 0, 0, 0});
+    return rings.size() - 1;
+}
+
+void GeometryStore::clear() {
+    origins.clear();
+    rings.clear();
+    stream.clear();
+    totalPoints = 0;
+}
+
+std::size_t GeometryStore::getRingCount() const {
+    return rings.size();
+}
+
+std::size_t GeometryStore::getPointCount(std::size_t ring) const {
+    return rings[ring].pointCount;
+}
+
+std::size_t GeometryStore::getTotalPointCount() const {
+    return totalPoints;
+}
+
+double GeometryStore::getQuantum() const {
+    return quantum;
+}
+
+void GeometryStore::shrinkToFit() {
+    origins.shrink_to_fit();
+    rings.shrink_to_fit();
+    stream.shrink_to_fit();
+}
+
+std::size_t GeometryStore::getMemoryUsage() const {
+    return sizeof(*this)
+        + origins.capacity() * sizeof(Origin)
+        + rings.capacity() * sizeof(Ring)
+        + stream.capacity() * sizeof(std::uint8_t);
+}
@@ -0,0 +1,97 @@
+#ifndef MAP_GEOMETRY_STORE_HPP
+#define MAP_GEOMETRY_STORE_HPP
+
+#include <cstdint>
+#include <vector>
+
+// Compact ring storage for map geometry.
+// Coordinates are quantised to integer steps of `quantum` map units. Every ring keeps its
+// first point as int32 relative to an int64 origin (one per feature, a new one is opened
+// when a ring would not fit), the following points are zigzag varint deltas, so short
+// border segments take a byte or two per axis instead of a float.
+// Decoding is exact: the quantised value is rebuilt in integers before it is scaled.
+class GeometryStore {
+public:
+    explicit GeometryStore(double quantum = 1e-6);
+
+    // Rings added after this are encoded relative to the given point
+    void beginFeature(double originX, double originY);
+
+    // xy is interleaved x, y pairs, returns the ring index
+    std::size_t addRing(const double* xy, std::size_t pointCount);
+    // Adds an empty ring, keeps ring indices aligned across stores
+    std::size_t addEmptyRing();
+
+    void clear();
+
+    std::size_t getRingCount() const;
+    std::size_t getPointCount(std::size_t ring) const;
+    std::size_t getTotalPointCount() const;
+    double getQuantum() const;
+
+    // Bytes held by the store, including unused capacity
+    std::size_t getMemoryUsage() const;
+    void shrinkToFit();
+
+    // Calls visit(x, y) with every point of the ring in map units, no allocation
+    template <class Visitor>
+    void forEachPoint(std::size_t ring, Visitor&& visit) const;
+
+private:
+    struct Ring {
+        std::uint32_t streamOffset;
+        std::uint32_t pointCount;
+        std::int32_t firstX;
+        std::int32_t firstY;
+        std::uint32_t origin;
+    };
+
+    struct Origin {
+        std::int64_t x;
+        std::int64_t y;
+    };
+
+    double quantum;
+    std::vector<Origin> origins;
+    std::vector<Ring> rings;
+    std::vector<std::uint8_t> stream;
+    std::size_t totalPoints = 0;
+
+    std::int64_t quantise(double value) const;
+    void pushDelta(std::int64_t delta);
+    static std::int64_t readDelta(const std::uint8_t*& cursor);
+};
+
+template <class Visitor>
+void GeometryStore::forEachPoint(std::size_t ring, Visitor&& visit) const {
+    const Ring& record = rings[ring];
+    if (record.pointCount == 0) {
+        return;
+    }
+
+    const Origin& origin = origins[record.origin];
+    std::int64_t x = origin.x + record.firstX;
+    std::int64_t y = origin.y + record.firstY;
+    visit(x * quantum, y * quantum);
+
+    const std::uint8_t* cursor = stream.data() + record.streamOffset;
+    for (std::uint32_t i = 1; i < record.pointCount; ++i) {
+        x += readDelta(cursor);
+        y += readDelta(cursor);
+        visit(x * quantum, y * quantum);
+    }
+}
+
+inline std::int64_t GeometryStore::readDelta(const std::uint8_t*& cursor) {
+    std::uint64_t zigzag = 0;
+    int shift = 0;
+    std::uint8_t byte;
+    do {
+        byte = *cursor++;
+        zigzag |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    return static_cast<std::int64_t>(zigzag >> 1) ^ -static_cast<std::int64_t>(zigzag & 1);
+}
+
+#endif // MAP_GEOMETRY_STORE_HPP
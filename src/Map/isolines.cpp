@@ -0,0 +1,216 @@
+#include "isolines.hpp"
+#include "../Utils/thread_pool.hpp"
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <limits>
+#include <unordered_map>
+
+namespace {
+
+// Edges are keyed column by column from their first grid point, horizontal edges even and
+// vertical edges odd, so the keys of a column band form one compact range
+std::uint64_t horizontalEdge(int x, int y, std::size_t height) {
+    return (static_cast<std::uint64_t>(x) * height + y) * 2;
+}
+
+std::uint64_t verticalEdge(int x, int y, std::size_t height) {
+    return (static_cast<std::uint64_t>(x) * height + y) * 2 + 1;
+}
+
+} // namespace
+
+IsolineExtractor::IsolineExtractor(unsigned threadCount)
+    : threadCount(threadCount > 0 ? threadCount : ThreadPool::global().getThreadCount() + 1) {}
+
+void IsolineExtractor::traceBand(const std::vector<std::vector<double>>& grid, double level, int firstColumn, int lastColumn, std::vector<Segment>& segments) {
+    const int height = static_cast<int>(grid[0].size());
+
+    for (int x = firstColumn; x < lastColumn; ++x) {
+        const std::vector<double>& left = grid[x];
+        const std::vector<double>& right = grid[x + 1];
+        for (int y = 0; y + 1 < height; ++y) {
+            // Corners clockwise from (x, y): 0 top left, 1 top right, 2 bottom right, 3 bottom left
+            const double v0 = left[y], v1 = right[y], v2 = right[y + 1], v3 = left[y + 1];
+            const bool in0 = v0 >= level, in1 = v1 >= level, in2 = v2 >= level, in3 = v3 >= level;
+            if (in0 == in1 && in1 == in2 && in2 == in3) {
+                continue;
+            }
+
+            struct Crossing {
+                std::uint64_t key;
+                sf::Vector2f point;
+            };
+            const auto cross = [level](double a, double b) {
+                return static_cast<float>((level - a) / (b - a));
+            };
+            const Crossing top{horizontalEdge(x, y, height), sf::Vector2f(x + cross(v0, v1), static_cast<float>(y))};
+            const Crossing rightEdge{verticalEdge(x + 1, y, height), sf::Vector2f(static_cast<float>(x + 1), y + cross(v1, v2))};
+            const Crossing bottom{horizontalEdge(x, y + 1, height), sf::Vector2f(x + cross(v3, v2), static_cast<float>(y + 1))};
+            const Crossing leftEdge{verticalEdge(x, y, height), sf::Vector2f(static_cast<float>(x), y + cross(v0, v3))};
+
+            const auto addSegment = [&segments](const Crossing& a, const Crossing& b) {
+                segments.push_back({a.key, b.key, false, {a.point, b.point}});
+            };
+
+            if (in0 != in1 && in1 != in2 && in2 != in3) {
+                // Saddle, the cell centre decides which opposite corners are connected
+                const bool centre = (v0 + v1 + v2 + v3) / 4.0 >= level;
+                if (centre == in0) {
+                    addSegment(top, rightEdge);
+                    addSegment(bottom, leftEdge);
+                } else {
+                    addSegment(leftEdge, top);
+                    addSegment(rightEdge, bottom);
+                }
+                continue;
+            }
+
+            const Crossing* ends[2];
+            int count = 0;
+            if (in0 != in1) ends[count++] = &top;
+            if (in1 != in2) ends[count++] = &rightEdge;
+            if (in3 != in2) ends[count++] = &bottom;
+            if (in0 != in3) ends[count++] = &leftEdge;
+            addSegment(*ends[0], *ends[1]);
+        }
+    }
+}
+
+template <class Input>
+std::vector<IsolineExtractor::Piece> IsolineExtractor::stitch(std::vector<Input>& pieces) {
+    std::vector<Piece> result;
+
+    // Every grid edge is shared by at most two pieces of the same level. The keys of one band
+    // fit a flat table, the few lines joined across bands go through a hash map.
+    std::uint64_t minKey = std::numeric_limits<std::uint64_t>::max();
+    std::uint64_t maxKey = 0;
+    for (const Input& piece : pieces) {
+        minKey = std::min({minKey, piece.frontKey, piece.backKey});
+        maxKey = std::max({maxKey, piece.frontKey, piece.backKey});
+    }
+    const bool dense = !pieces.empty() && maxKey - minKey < (std::uint64_t(1) << 20);
+    std::vector<std::array<int, 2>> table;
+    std::unordered_map<std::uint64_t, std::array<int, 2>> map;
+    if (dense) {
+        table.assign(maxKey - minKey + 1, std::array<int, 2>{-1, -1});
+    } else {
+        map.reserve(pieces.size() * 2);
+    }
+    const auto slot = [&](std::uint64_t key) -> std::array<int, 2>* {
+        if (dense) {
+            return &table[key - minKey];
+        }
+        auto it = map.find(key);
+        return it == map.end() ? nullptr : &it->second;
+    };
+    const auto link = [&](std::uint64_t key, int piece) {
+        std::array<int, 2>& ends = dense ? table[key - minKey] : map.emplace(key, std::array<int, 2>{-1, -1}).first->second;
+        ends[ends[0] < 0 ? 0 : 1] = piece;
+    };
+    for (int i = 0; i < static_cast<int>(pieces.size()); ++i) {
+        if (pieces[i].closed) {
+            result.push_back({pieces[i].frontKey, pieces[i].backKey, true, {pieces[i].points.begin(), pieces[i].points.end()}});
+            continue;
+        }
+        link(pieces[i].frontKey, i);
+        link(pieces[i].backKey, i);
+    }
+
+    std::vector<char> used(pieces.size(), 0);
+    const auto next = [&](std::uint64_t key) {
+        const std::array<int, 2>* ends = slot(key);
+        if (!ends) {
+            return -1;
+        }
+        for (int candidate : *ends) {
+            if (candidate >= 0 && !used[candidate]) {
+                return candidate;
+            }
+        }
+        return -1;
+    };
+
+    std::vector<sf::Vector2f> head;
+    for (int i = 0; i < static_cast<int>(pieces.size()); ++i) {
+        if (used[i] || pieces[i].closed) {
+            continue;
+        }
+        used[i] = 1;
+        Piece line{pieces[i].frontKey, pieces[i].backKey, false, {pieces[i].points.begin(), pieces[i].points.end()}};
+
+        // Walk forward from the back end, a loop closes when it reaches the front key again
+        for (int j = next(line.backKey); j >= 0; j = next(line.backKey)) {
+            used[j] = 1;
+            const Input& piece = pieces[j];
+            if (piece.frontKey == line.backKey) {
+                line.points.insert(line.points.end(), piece.points.begin() + 1, piece.points.end());
+                line.backKey = piece.backKey;
+            } else {
+                line.points.insert(line.points.end(), piece.points.rbegin() + 1, piece.points.rend());
+                line.backKey = piece.frontKey;
+            }
+            if (line.backKey == line.frontKey) {
+                line.closed = true;
+                break;
+            }
+        }
+
+        // Then outward from the front end, collected reversed and prepended once
+        head.clear();
+        for (int j = line.closed ? -1 : next(line.frontKey); j >= 0; j = next(line.frontKey)) {
+            used[j] = 1;
+            const Input& piece = pieces[j];
+            if (piece.backKey == line.frontKey) {
+                head.insert(head.end(), piece.points.rbegin() + 1, piece.points.rend());
+                line.frontKey = piece.frontKey;
+            } else {
+                head.insert(head.end(), piece.points.begin() + 1, piece.points.end());
+                line.frontKey = piece.backKey;
+            }
+        }
+        line.points.insert(line.points.begin(), head.rbegin(), head.rend());
+
+        result.push_back(std::move(line));
+    }
+    return result;
+}
+
+std::vector<Isoline> IsolineExtractor::extract(const std::vector<std::vector<double>>& grid, const std::vector<double>& levels) const {
+    std::vector<Isoline> isolines;
+    if (grid.size() < 2 || grid[0].size() < 2 || levels.empty()) {
+        return isolines;
+    }
+
+    // Trace and stitch the column bands on the shared pool
+    const int columns = static_cast<int>(grid.size()) - 1;
+    const int bandCount = std::min<int>(threadCount, columns);
+    std::vector<std::vector<std::vector<Piece>>> bands(bandCount, std::vector<std::vector<Piece>>(levels.size()));
+    ThreadPool::global().parallelFor(0, bandCount, 1, [&](std::size_t firstBand, std::size_t lastBand) {
+        std::vector<Segment> segments;
+        for (std::size_t band = firstBand; band < lastBand; ++band) {
+            const int firstColumn = columns * static_cast<int>(band) / bandCount;
+            const int lastColumn = columns * static_cast<int>(band + 1) / bandCount;
+            for (std::size_t level = 0; level < levels.size(); ++level) {
+                segments.clear();
+                traceBand(grid, levels[level], firstColumn, lastColumn, segments);
+                bands[band][level] = stitch(segments);
+            }
+        }
+    });
+
+    std::vector<std::vector<Piece>> bandPieces(levels.size());
+    for (auto& pieces : bands) {
+        for (std::size_t level = 0; level < levels.size(); ++level) {
+            std::move(pieces[level].begin(), pieces[level].end(), std::back_inserter(bandPieces[level]));
+        }
+    }
+
+    // Join the lines that cross band borders, closed ones pass straight through
+    for (std::size_t level = 0; level < levels.size(); ++level) {
+        for (Piece& piece : stitch(bandPieces[level])) {
+            isolines.push_back({levels[level], piece.closed, std::move(piece.points)});
+        }
+    }
+    return isolines;
+}
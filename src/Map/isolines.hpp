@@ -0,0 +1,52 @@
+#ifndef MAP_ISOLINES_HPP
+#define MAP_ISOLINES_HPP
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// One stitched isoline in grid coordinates, grid[x][y] sits at (x, y).
+// A closed line repeats its first point at the end.
+struct Isoline {
+    double level;
+    bool closed;
+    std::vector<sf::Vector2f> points;
+};
+
+class IsolineExtractor {
+public:
+    // threadCount bands are traced at once on the shared pool, 0 uses one per pool thread plus the caller
+    explicit IsolineExtractor(unsigned threadCount = 0);
+
+    // Marching squares over grid[x][y] for every level. The grid is cut into column bands
+    // that are traced in parallel, and lines are joined across band borders by the key of
+    // the grid edge they cross, so the output does not depend on the band count.
+    std::vector<Isoline> extract(const std::vector<std::vector<double>>& grid, const std::vector<double>& levels) const;
+
+private:
+    // Part of a line with the grid edges its two ends lie on
+    struct Piece {
+        std::uint64_t frontKey;
+        std::uint64_t backKey;
+        bool closed;
+        std::vector<sf::Vector2f> points;
+    };
+
+    // One marching squares cell crossing, kept off the heap until it is stitched
+    struct Segment {
+        std::uint64_t frontKey;
+        std::uint64_t backKey;
+        bool closed;
+        std::array<sf::Vector2f, 2> points;
+    };
+
+    unsigned threadCount;
+
+    static void traceBand(const std::vector<std::vector<double>>& grid, double level, int firstColumn, int lastColumn, std::vector<Segment>& segments);
+    // Joins segments or pieces that end on the same grid edge into lines
+    template <class Input>
+    static std::vector<Piece> stitch(std::vector<Input>& pieces);
+};
+
+#endif // MAP_ISOLINES_HPP
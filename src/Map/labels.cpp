@@ -0,0 +1,158 @@
+#include "labels.hpp"
+#include <algorithm>
+#include <cmath>
+
+sf::Vector2f LabelLayer::calculateAnchor(const sf::VertexArray& polygon, float& area) {
+    const std::size_t count = polygon.getVertexCount();
+    area = 0.0f;
+    if (count == 0) {
+        return sf::Vector2f(0.0f, 0.0f);
+    }
+
+    // Shoelace centroid, accumulated relative to the first vertex to keep precision
+    const sf::Vector2f origin = polygon[0].position;
+    double twiceArea = 0.0;
+    double cx = 0.0;
+    double cy = 0.0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const sf::Vector2f a = polygon[i].position - origin;
+        const sf::Vector2f b = polygon[(i + 1) % count].position - origin;
+        const double cross = static_cast<double>(a.x) * b.y - static_cast<double>(b.x) * a.y;
+        twiceArea += cross;
+        cx += (a.x + b.x) * cross;
+        cy += (a.y + b.y) * cross;
+    }
+
+    if (std::abs(twiceArea) < 1e-12) {
+        // Degenerate ring, fall back to the vertex average
+        double sumX = 0.0;
+        double sumY = 0.0;
+        for (std::size_t i = 0; i < count; ++i) {
+            sumX += polygon[i].position.x;
+            sumY += polygon[i].position.y;
+        }
+        return sf::Vector2f(static_cast<float>(sumX / count), static_cast<float>(sumY / count));
+    }
+
+    area = static_cast<float>(std::abs(twiceArea) / 2.0);
+    return sf::Vector2f(
+        static_cast<float>(origin.x + cx / (3.0 * twiceArea)),
+        static_cast<float>(origin.y + cy / (3.0 * twiceArea))
+    );
+}
+
+void LabelLayer::build(const std::vector<sf::VertexArray>& polygons, const std::vector<std::string>& names, const sf::Font& font) {
+    labels.clear();
+    placed.clear();
+    placedBounds.clear();
+    placedOffset = sf::Vector2f(0.0f, 0.0f);
+    layoutValid = false;
+    layoutCharacterSize = 0;
+    layoutColor = sf::Color::Transparent;
+    labels.reserve(polygons.size());
+
+    for (std::size_t i = 0; i < polygons.size(); i++) {
+        CountryLabel label;
+        label.polygonIndex = i;
+        label.anchor = calculateAnchor(polygons[i], label.area);
+
+        const std::string displayName = (i < names.size() && !names[i].empty()) ? names[i] : "Unknown";
+        label.text = sf::Text(displayName, font);
+        label.text.setOutlineColor(sf::Color::Black);
+        label.text.setOutlineThickness(1.0f);
+        labels.push_back(std::move(label));
+    }
+
+    // Larger countries win label collisions
+    std::stable_sort(labels.begin(), labels.end(), [](const CountryLabel& a, const CountryLabel& b) {
+        return a.area > b.area;
+    });
+}
+
+void LabelLayer::layout(const sf::Transform& mapTransform, unsigned int characterSize, const sf::Color& fillColor) {
+    if (fillColor != layoutColor) {
+        for (auto& label : labels) {
+            label.text.setFillColor(fillColor);
+        }
+        layoutColor = fillColor;
+    }
+
+    sf::Clock clock;
+    const float* matrix = mapTransform.getMatrix();
+    const float scale[4] = {matrix[0], matrix[1], matrix[4], matrix[5]};
+    const sf::Vector2f translation(matrix[12], matrix[13]);
+    if (layoutValid && characterSize == layoutCharacterSize && std::equal(scale, scale + 4, layoutScale)) {
+        if (translation != layoutTranslation) {
+            // Panned: same overlaps, only the placed labels move
+            for (std::size_t index : placed) {
+                labels[index].text.setPosition(mapTransform.transformPoint(labels[index].anchor));
+            }
+            placedOffset += translation - layoutTranslation;
+            layoutTranslation = translation;
+        }
+        layoutTime = clock.getElapsedTime();
+        return;
+    }
+
+    if (characterSize != layoutCharacterSize) {
+        for (auto& label : labels) {
+            label.text.setCharacterSize(characterSize);
+            const sf::FloatRect bounds = label.text.getLocalBounds();
+            label.text.setOrigin(bounds.left + bounds.width / 2.0f, bounds.top + bounds.height / 2.0f);
+        }
+        layoutCharacterSize = characterSize;
+    }
+    std::copy(scale, scale + 4, layoutScale);
+    layoutTranslation = translation;
+    placedOffset = sf::Vector2f(0.0f, 0.0f);
+    layoutValid = true;
+
+    // Greedy placement in priority order, a label is kept only if it overlaps nothing placed before it
+    placed.clear();
+    placedBounds.clear();
+    for (std::size_t i = 0; i < labels.size(); i++) {
+        auto& label = labels[i];
+        label.text.setPosition(mapTransform.transformPoint(label.anchor));
+        const sf::FloatRect bounds = label.text.getGlobalBounds();
+
+        bool overlaps = false;
+        for (const auto& other : placedBounds) {
+            if (bounds.intersects(other)) {
+                overlaps = true;
+                break;
+            }
+        }
+        if (!overlaps) {
+            placed.push_back(i);
+            placedBounds.push_back(bounds);
+        }
+    }
+    layoutTime = clock.getElapsedTime();
+}
+
+void LabelLayer::draw(sf::RenderTarget& target) const {
+    const sf::View& view = target.getView();
+    // Bounds are kept where the collision pass put them, move the view instead
+    const sf::FloatRect viewRect(view.getCenter() - view.getSize() / 2.0f - placedOffset, view.getSize());
+
+    visibleCount = 0;
+    for (std::size_t i = 0; i < placed.size(); i++) {
+        if (!placedBounds[i].intersects(viewRect)) {
+            continue;
+        }
+        target.draw(labels[placed[i]].text);
+        ++visibleCount;
+    }
+}
+
+std::size_t LabelLayer::getPlacedCount() const {
+    return placed.size();
+}
+
+std::size_t LabelLayer::getVisibleCount() const {
+    return visibleCount;
+}
+
+sf::Time LabelLayer::getLayoutTime() const {
+    return layoutTime;
+}
@@ -0,0 +1,50 @@
+#ifndef MAP_LABELS_HPP
+#define MAP_LABELS_HPP
+
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
+
+struct CountryLabel {
+    std::size_t polygonIndex;
+    sf::Vector2f anchor;   // area-weighted centroid in map space
+    float area;            // absolute ring area, used as placement priority
+    sf::Text text;         // glyph layout is built once and reused every frame
+};
+
+class LabelLayer {
+public:
+    // Compute anchors and text layouts for every named polygon, largest first
+    void build(const std::vector<sf::VertexArray>& polygons, const std::vector<std::string>& names, const sf::Font& font);
+
+    // Greedy collision pass, only re-run when the map scale or font settings change. Overlaps don't
+    // change when the map only moves, so a pan just translates the placed labels
+    void layout(const sf::Transform& mapTransform, unsigned int characterSize, const sf::Color& fillColor);
+
+    // Draw the placed labels that intersect the target's current view
+    void draw(sf::RenderTarget& target) const;
+
+    std::size_t getPlacedCount() const;
+    std::size_t getVisibleCount() const;
+    // CPU time of the last layout() call, collision pass or translation
+    sf::Time getLayoutTime() const;
+
+    static sf::Vector2f calculateAnchor(const sf::VertexArray& polygon, float& area);
+
+private:
+    std::vector<CountryLabel> labels;
+    std::vector<std::size_t> placed;           // indices into labels that survived collision culling
+    std::vector<sf::FloatRect> placedBounds;   // screen-space bounds matching placed, at the collision pass's translation
+    sf::Vector2f placedOffset;                 // translation since the collision pass
+    mutable std::size_t visibleCount = 0;
+    sf::Time layoutTime;
+
+    // Layout cache key, the linear part of the map transform
+    float layoutScale[4] = {};
+    sf::Vector2f layoutTranslation;
+    unsigned int layoutCharacterSize = 0;
+    sf::Color layoutColor = sf::Color::Transparent;
+    bool layoutValid = false;
+};
+
+#endif // MAP_LABELS_HPP
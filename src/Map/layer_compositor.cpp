@@ -0,0 +1,101 @@
+#include "layer_compositor.hpp"
+#include <cmath>
+#include <iostream>
+
+LayerCompositor::LayerCompositor(unsigned margin) : margin(margin) {}
+
+std::size_t LayerCompositor::addLayer(DrawFunction draw) {
+    auto layer = std::make_unique<Layer>();
+    layer->draw = std::move(draw);
+    layers.push_back(std::move(layer));
+    return layers.size() - 1;
+}
+
+void LayerCompositor::markDirty(std::size_t layer) {
+    layers[layer]->dirty = true;
+}
+
+void LayerCompositor::markAllDirty() {
+    for (auto& layer : layers) {
+        layer->dirty = true;
+    }
+}
+
+void LayerCompositor::setVisible(std::size_t layer, bool visible) {
+    // A hidden layer stops tracking changes, so it is re-rendered when shown again
+    layers[layer]->dirty = layers[layer]->dirty || visible != layers[layer]->visible;
+    layers[layer]->visible = visible;
+}
+
+std::size_t LayerCompositor::getRenderCount() const {
+    return renderCount;
+}
+
+bool LayerCompositor::isCacheValid(const Layer& layer, const sf::FloatRect& viewRect, const sf::Vector2f& cacheWorldSize, const sf::Vector2u& cacheSize) const {
+    if (layer.dirty || layer.cache.getSize() != cacheSize) {
+        return false;
+    }
+
+    // Any zoom change means the cached pixels are at the wrong scale
+    const float tolerance = 1e-4f;
+    if (std::abs(layer.cachedRect.width - cacheWorldSize.x) > tolerance * cacheWorldSize.x
+        || std::abs(layer.cachedRect.height - cacheWorldSize.y) > tolerance * cacheWorldSize.y) {
+        return false;
+    }
+
+    return viewRect.left >= layer.cachedRect.left && viewRect.top >= layer.cachedRect.top
+        && viewRect.left + viewRect.width <= layer.cachedRect.left + layer.cachedRect.width
+        && viewRect.top + viewRect.height <= layer.cachedRect.top + layer.cachedRect.height;
+}
+
+void LayerCompositor::draw(sf::RenderTarget& target) {
+    const sf::View& view = target.getView();
+    const sf::Vector2u windowSize = target.getSize();
+    const sf::Vector2u cacheSize(windowSize.x + 2 * margin, windowSize.y + 2 * margin);
+    const sf::Vector2f unitsPerPixel(view.getSize().x / windowSize.x, view.getSize().y / windowSize.y);
+    const sf::Vector2f cacheWorldSize(cacheSize.x * unitsPerPixel.x, cacheSize.y * unitsPerPixel.y);
+    const sf::FloatRect viewRect(view.getCenter() - view.getSize() / 2.0f, view.getSize());
+
+    // The cached texture is premultiplied by the alpha blending it was drawn with
+    const sf::RenderStates blitStates(sf::BlendMode(sf::BlendMode::One, sf::BlendMode::OneMinusSrcAlpha));
+
+    renderCount = 0;
+    for (auto& layerPtr : layers) {
+        Layer& layer = *layerPtr;
+        if (!layer.visible) {
+            continue;
+        }
+
+        // Rotated views are not cached
+        if (view.getRotation() != 0.0f) {
+            layer.draw(target, windowSize);
+            layer.dirty = true;
+            ++renderCount;
+            continue;
+        }
+
+        if (!isCacheValid(layer, viewRect, cacheWorldSize, cacheSize)) {
+            if (layer.cache.getSize() != cacheSize && !layer.cache.create(cacheSize.x, cacheSize.y)) {
+                std::cerr << "Failed to create layer cache" << std::endl;
+                layer.draw(target, windowSize);
+                continue;
+            }
+
+            layer.cachedRect = sf::FloatRect(
+                viewRect.left - margin * unitsPerPixel.x, viewRect.top - margin * unitsPerPixel.y,
+                cacheWorldSize.x, cacheWorldSize.y
+            );
+            layer.cache.setView(sf::View(layer.cachedRect));
+            layer.cache.clear(sf::Color::Transparent);
+            layer.draw(layer.cache, windowSize);
+            layer.cache.display();
+            layer.dirty = false;
+            ++renderCount;
+        }
+
+        sf::Sprite blit(layer.cache.getTexture());
+        blit.setPosition(layer.cachedRect.left, layer.cachedRect.top);
+        blit.setScale(unitsPerPixel);
+        target.draw(blit, blitStates);
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef MAP_LAYER_COMPOSITOR_HPP
+#define MAP_LAYER_COMPOSITOR_HPP
+
+#include <SFML/Graphics.hpp>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Keeps each static layer in an offscreen texture a margin larger than the window and blits it.
+// A layer is re-rendered only when it is marked dirty, the zoom changes or the view leaves the
+// cached area; panning inside the margin just moves the blit.
+class LayerCompositor {
+public:
+    // windowSize is the size of the real target, layers that fit themselves to the window use it
+    // rather than the size of the cache they are drawn into
+    using DrawFunction = std::function<void(sf::RenderTarget& target, const sf::Vector2u& windowSize)>;
+
+    // margin: screen pixels cached past each edge of the view
+    explicit LayerCompositor(unsigned margin = 256);
+
+    // Layers are composited in the order they are added, the returned index names the layer
+    std::size_t addLayer(DrawFunction draw);
+    void markDirty(std::size_t layer);
+    void markAllDirty();
+    void setVisible(std::size_t layer, bool visible);
+
+    void draw(sf::RenderTarget& target);
+
+    // Layers re-rendered by the last draw, the rest were blitted from their cache
+    std::size_t getRenderCount() const;
+
+private:
+    struct Layer {
+        DrawFunction draw;
+        sf::RenderTexture cache;
+        sf::FloatRect cachedRect;   // world area held by the cache
+        bool dirty = true;
+        bool visible = true;
+    };
+
+    unsigned margin;
+    std::vector<std::unique_ptr<Layer>> layers;
+    std::size_t renderCount = 0;
+
+    bool isCacheValid(const Layer& layer, const sf::FloatRect& viewRect, const sf::Vector2f& cacheWorldSize, const sf::Vector2u& cacheSize) const;
+};
+
+#endif // MAP_LAYER_COMPOSITOR_HPP
@@ -4,38 +4,50 @@ MapDrawTexture::MapDrawTexture(ProgressBar& progressBar)
     : progressBar(progressBar) {}
 
 void MapDrawTexture::loadTexturesAsync() {
-    // Run each texture loading in a separate async task
-    std::vector<std::future<void>> futures;
-
-    futures.emplace_back(std::async(std::launch::async, [this]() {
-        lowResTexture.loadFromFile("res/Earth-Small.png");
-        progressBar.incrementProgress();
-    }));
-
-    futures.emplace_back(std::async(std::launch::async, [this]() {
-        highResTexture.loadFromFile("res/Earth-Large.png");
+    // A tile pyramid streams in while drawing. Its two steps are the metadata, read here, and the
+    // root tile, which updateMapTexture reports once it is resident
+    if (tiles.open("res/tiles/earth")) {
         progressBar.incrementProgress();
-    }));
-
-    // Wait for all textures to load
-    for (auto& future : futures) {
-        future.get(); // Wait for each async task to complete
+        return;
     }
 
-    // Set the initial texture after loading
-    mapSprite.setTexture(lowResTexture);
+    // Decoding happens off thread, the GL upload is spread over the following frames
+    uploader.enqueue("res/Earth-Small.png", lowResTexture, [this](bool loaded) {
+        lowResReady = loaded;
+        progressBar.incrementProgress();
+    });
+    uploader.enqueue("res/Earth-Large.png", highResTexture, [this](bool loaded) {
+        highResReady = loaded;
+        progressBar.incrementProgress();
+    });
 }
 
 void MapDrawTexture::updateMapTexture(float zoomFactor, const sf::Vector2u& windowSize) {
     currentZoomFactor = zoomFactor;
+    currentWindowSize = windowSize;
+    if (tiles.isOpen()) {
+        tiles.update();
+        if (!rootTileReady && tiles.isRootReady()) {
+            rootTileReady = true;
+            progressBar.incrementProgress();
+        }
+        return;
+    }
 
-    // Switch to high resolution if zoomed in enough, otherwise use low resolution
-    if (zoomFactor < 0.5f && isHighResActive) {  // Far out: low resolution
-        mapSprite.setTexture(lowResTexture, true);
-        isHighResActive = false;
-    } else if (zoomFactor >= 0.5f && !isHighResActive) {  // Close in: switch to high resolution
-        mapSprite.setTexture(highResTexture, true);
-        isHighResActive = true;
+    uploader.update();
+
+    // Switch to high resolution if zoomed in enough, otherwise use low resolution.
+    // Until the high resolution texture is uploaded the low resolution one stands in for it
+    const bool useHighRes = highResReady && (zoomFactor >= 0.5f || !lowResReady);
+    if (useHighRes != isHighResActive || !mapSprite.getTexture()) {
+        if (useHighRes) {
+            mapSprite.setTexture(highResTexture, true);
+        } else if (lowResReady) {
+            mapSprite.setTexture(lowResTexture, true);
+        } else {
+            return;
+        }
+        isHighResActive = useHighRes;
     }
 
     // Calculate scaling factor to fit the map to the screen for both textures
@@ -53,11 +65,78 @@ void MapDrawTexture::updateMapTexture(float zoomFactor, const sf::Vector2u& wind
     // );
 }
 
-void MapDrawTexture::draw(sf::RenderWindow& window) {
-    window.draw(mapSprite);
+void MapDrawTexture::draw(sf::RenderTarget& window) {
+    if (!tiles.isOpen()) {
+        window.draw(mapSprite);
+        return;
+    }
+
+    // World units per full resolution pixel, the same fit-to-window scale the whole textures use
+    const sf::Vector2u imageSize = tiles.getImageSize();
+    const sf::Vector2f scale(
+        static_cast<float>(currentWindowSize.x) * currentZoomFactor / imageSize.x,
+        static_cast<float>(currentWindowSize.y) * currentZoomFactor / imageSize.y
+    );
+    if (scale.x <= 0.0f || scale.y <= 0.0f) {
+        return;
+    }
+
+    const sf::View& view = window.getView();
+    const sf::Vector2f viewTopLeft = view.getCenter() - view.getSize() / 2.0f;
+    const sf::FloatRect imageRect(
+        viewTopLeft.x / scale.x, viewTopLeft.y / scale.y,
+        view.getSize().x / scale.x, view.getSize().y / scale.y
+    );
+    const float screenPixelsPerImagePixel = scale.x * window.getSize().x / view.getSize().x;
+
+    tiles.request(imageRect, tiles.selectLevel(screenPixelsPerImagePixel), drawableTiles);
+
+    sf::Sprite tileSprite;
+    for (const TextureTile* tile : drawableTiles) {
+        const sf::Vector2u textureSize = tile->texture.getSize();
+        tileSprite.setTexture(tile->texture, true);
+        tileSprite.setPosition(tile->imageRect.left * scale.x, tile->imageRect.top * scale.y);
+        tileSprite.setScale(
+            tile->imageRect.width * scale.x / textureSize.x,
+            tile->imageRect.height * scale.y / textureSize.y
+        );
+        window.draw(tileSprite);
+    }
 }
 
 sf::Vector2u MapDrawTexture::getTextureSize() {
-    return lowResTexture.getSize();
+    return tiles.isOpen() ? tiles.getImageSize() : lowResTexture.getSize();
+}
+
+bool MapDrawTexture::isLoaded() const {
+    return tiles.isOpen() ? rootTileReady : uploader.isIdle();
+}
+
+bool MapDrawTexture::isTiled() const {
+    return tiles.isOpen();
+}
+
+std::size_t MapDrawTexture::getResidentTileCount() const {
+    return tiles.getResidentCount();
+}
+
+std::size_t MapDrawTexture::getPendingTileCount() const {
+    return tiles.getPendingCount();
+}
+
+std::size_t MapDrawTexture::getTileMemoryUsage() const {
+    return tiles.getMemoryUsage();
+}
+
+void MapDrawTexture::reportMemory(MemoryRegistry& registry) const {
+    MemoryUsage earth;
+    for (const sf::Texture* texture : {&lowResTexture, &highResTexture}) {
+        const sf::Vector2u size = texture->getSize();
+        if (size.x > 0 && size.y > 0) {
+            earth += {static_cast<std::size_t>(size.x) * size.y * 4, 1};
+        }
+    }
+    registry.report("textures.earth", earth);
+    registry.report("textures.tiles", {tiles.getMemoryUsage(), tiles.getResidentCount()});
 }
 
@@ -2,24 +2,47 @@
 #define MAP_TEXTURE_HPP
 
 #include <SFML/Graphics.hpp>
+#include "../Utils/memory_registry.hpp"
 #include "../Utils/progressbar.hpp"
+#include "texture_tiles.hpp"
+#include "texture_uploader.hpp"
 #include <future>
 
 class MapDrawTexture {
 public:
     MapDrawTexture(ProgressBar& progressBar);
+    // Starts decoding on worker threads and returns, the textures arrive through updateMapTexture
     void loadTexturesAsync();
+    // Main thread, once per frame: uploads what has been decoded and picks the texture for the zoom
     void updateMapTexture(float zoomFactor, const sf::Vector2u& windowSize);
-    void draw(sf::RenderWindow& window);
+    void draw(sf::RenderTarget& window);
     sf::Vector2u getTextureSize();
 
+    // Both textures are uploaded or failed to load, or the tile pyramid's root tile is ready
+    bool isLoaded() const;
+    bool isTiled() const;
+    std::size_t getResidentTileCount() const;
+    std::size_t getPendingTileCount() const;
+    std::size_t getTileMemoryUsage() const;
+    // Texture memory of the whole-map textures and the resident tiles under "textures"
+    void reportMemory(MemoryRegistry& registry) const;
+
 private:
     sf::Texture lowResTexture;
     sf::Texture highResTexture;
     sf::Sprite mapSprite;
     bool isHighResActive = false;
+    bool lowResReady = false;
+    bool highResReady = false;
+    TextureUploader uploader;
     float currentZoomFactor = 1.0f;
 
+    // Used instead of the two whole textures when res/tiles/earth holds a pyramid
+    TextureTileCache tiles;
+    std::vector<const TextureTile*> drawableTiles;
+    bool rootTileReady = false;
+    sf::Vector2u currentWindowSize;
+
     ProgressBar& progressBar;
 };
 
@@ -0,0 +1,59 @@
+#include "noise_cache.hpp"
+#include <algorithm>
+
+NoiseState::NoiseState(seed_type seed) : seed(seed) {
+    // The library's shuffle, so the values match siv::PerlinNoise(seed) exactly
+    const siv::PerlinNoise::state_type source = siv::PerlinNoise(seed).serialize();
+    std::copy(source.begin(), source.end(), permutation.begin());
+    std::copy(source.begin(), source.end(), permutation.begin() + source.size());
+}
+
+NoiseState::seed_type NoiseState::getSeed() const {
+    return seed;
+}
+
+NoiseState::seed_type deriveNoiseSeed(NoiseState::seed_type seed, NoiseChannel channel) {
+    // The channel goes in the high half, every (seed, channel) pair hashes a distinct input
+    std::uint64_t z = (static_cast<std::uint64_t>(seed) & 0xffffffffull) ^ (static_cast<std::uint64_t>(channel) << 32);
+    z += 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    z ^= z >> 31;
+    return static_cast<NoiseState::seed_type>(z);
+}
+
+NoiseCache::NoiseCache(std::size_t capacity) : capacity(std::max<std::size_t>(1, capacity)) {}
+
+NoiseCache& NoiseCache::global() {
+    static NoiseCache cache;
+    return cache;
+}
+
+std::shared_ptr<const NoiseState> NoiseCache::get(NoiseState::seed_type seed) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = std::find_if(states.begin(), states.end(), [seed](const std::shared_ptr<const NoiseState>& state) {
+        return state->getSeed() == seed;
+    });
+    if (it != states.end()) {
+        ++hits;
+        std::rotate(it, it + 1, states.end());
+        return states.back();
+    }
+
+    ++misses;
+    if (states.size() >= capacity) {
+        states.erase(states.begin());
+    }
+    states.push_back(std::make_shared<const NoiseState>(seed));
+    return states.back();
+}
+
+std::size_t NoiseCache::getHitCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hits;
+}
+
+std::size_t NoiseCache::getMissCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return misses;
+}
@@ -0,0 +1,168 @@
+#ifndef MAP_NOISE_CACHE_HPP
+#define MAP_NOISE_CACHE_HPP
+
+#include <PerlinNoise.hpp>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// siv::PerlinNoise's permutation for one seed, stored twice in a row so every lookup is p[i] with
+// i < 512: no wrap-around masks between the dependent loads of a sample. Gradients come from a table
+// instead of the library's branches on the hash, which mispredict once neighbouring samples fall
+// in different cells at higher octaves. Gives exactly the values of siv::PerlinNoise(seed), and
+// works with its octave helpers.
+class NoiseState {
+public:
+    using seed_type = siv::PerlinNoise::seed_type;
+
+    // The part of a sample that only depends on the position, states with different seeds can share it
+    struct Lattice {
+        Lattice(double x, double y, double z);
+
+        int ix;
+        int iy;
+        int iz;
+        double fx;
+        double fy;
+        double fz;
+        double u;
+        double v;
+        double w;
+    };
+
+    explicit NoiseState(seed_type seed);
+
+    seed_type getSeed() const;
+    double noise2D(double x, double y) const;
+    double noise3D(double x, double y, double z) const;
+    double noise3D(const Lattice& lattice) const;
+
+private:
+    struct Gradient {
+        double x;
+        double y;
+        double z;
+    };
+
+    // perlin_detail::Grad for each value of hash & 15, as coefficients of x, y and z
+    static constexpr Gradient GRADIENTS[16] = {
+        {1, 1, 0}, {-1, 1, 0}, {1, -1, 0}, {-1, -1, 0},
+        {1, 0, 1}, {-1, 0, 1}, {1, 0, -1}, {-1, 0, -1},
+        {0, 1, 1}, {0, -1, 1}, {0, 1, -1}, {0, -1, -1},
+        {1, 1, 0}, {0, -1, 1}, {-1, 1, 0}, {0, -1, -1},
+    };
+
+    seed_type seed;
+    std::array<std::uint8_t, 512> permutation;
+
+    static double grad(std::uint8_t hash, double x, double y, double z);
+};
+
+// Noise fields of a map besides its height, each with a seed of its own
+enum class NoiseChannel : std::uint64_t {
+    Moisture = 1,
+    Temperature = 2,
+    WarpX = 3,
+    WarpY = 4,
+};
+
+// The seed of a map's channel: splitmix64 over the map seed and the channel, so a channel never
+// reuses the height field of a nearby map seed and neighbouring seeds get unrelated channels
+NoiseState::seed_type deriveNoiseSeed(NoiseState::seed_type seed, NoiseChannel channel);
+
+// Noise states by seed, shared by every thread. Regenerating with the same seed, or going back to
+// a recent one, skips seeding the generator and shuffling the table.
+class NoiseCache {
+public:
+    explicit NoiseCache(std::size_t capacity = 8);
+
+    // The cache terrain generation uses
+    static NoiseCache& global();
+
+    // Built on first use. The state stays valid for its holders after the cache drops the seed
+    std::shared_ptr<const NoiseState> get(NoiseState::seed_type seed);
+    std::size_t getHitCount() const;
+    std::size_t getMissCount() const;
+
+private:
+    std::size_t capacity;
+    mutable std::mutex mutex;
+    std::vector<std::shared_ptr<const NoiseState>> states;    // most recently used last
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+};
+
+// Inline, the octave kernels call these once per octave and sample
+inline double NoiseState::grad(std::uint8_t hash, double x, double y, double z) {
+    const Gradient& gradient = GRADIENTS[hash & 15];
+    return gradient.x * x + gradient.y * y + gradient.z * z;
+}
+
+inline double NoiseState::noise2D(double x, double y) const {
+    return noise3D(x, y, static_cast<double>(SIVPERLIN_DEFAULT_Z));
+}
+
+inline NoiseState::Lattice::Lattice(double x, double y, double z) {
+    using siv::perlin_detail::Fade;
+
+    const double floorX = std::floor(x);
+    const double floorY = std::floor(y);
+    const double floorZ = std::floor(z);
+
+    ix = static_cast<std::int32_t>(floorX) & 255;
+    iy = static_cast<std::int32_t>(floorY) & 255;
+    iz = static_cast<std::int32_t>(floorZ) & 255;
+
+    fx = x - floorX;
+    fy = y - floorY;
+    fz = z - floorZ;
+
+    u = Fade(fx);
+    v = Fade(fy);
+    w = Fade(fz);
+}
+
+inline double NoiseState::noise3D(double x, double y, double z) const {
+    return noise3D(Lattice(x, y, z));
+}
+
+inline double NoiseState::noise3D(const Lattice& lattice) const {
+    using siv::perlin_detail::Lerp;
+
+    const int ix = lattice.ix;
+    const int iy = lattice.iy;
+    const int iz = lattice.iz;
+    const double fx = lattice.fx;
+    const double fy = lattice.fy;
+    const double fz = lattice.fz;
+
+    // Every index stays below 511, so none of them needs the & 255 of the 256 entry table
+    const std::uint8_t* p = permutation.data();
+    const int a = p[ix] + iy;
+    const int b = p[ix + 1] + iy;
+    const int aa = p[a] + iz;
+    const int ab = p[a + 1] + iz;
+    const int ba = p[b] + iz;
+    const int bb = p[b + 1] + iz;
+
+    const double p0 = grad(p[aa], fx, fy, fz);
+    const double p1 = grad(p[ba], fx - 1, fy, fz);
+    const double p2 = grad(p[ab], fx, fy - 1, fz);
+    const double p3 = grad(p[bb], fx - 1, fy - 1, fz);
+    const double p4 = grad(p[aa + 1], fx, fy, fz - 1);
+    const double p5 = grad(p[ba + 1], fx - 1, fy, fz - 1);
+    const double p6 = grad(p[ab + 1], fx, fy - 1, fz - 1);
+    const double p7 = grad(p[bb + 1], fx - 1, fy - 1, fz - 1);
+
+    const double q0 = Lerp(p0, p1, lattice.u);
+    const double q1 = Lerp(p2, p3, lattice.u);
+    const double q2 = Lerp(p4, p5, lattice.u);
+    const double q3 = Lerp(p6, p7, lattice.u);
+
+    return Lerp(Lerp(q0, q1, lattice.v), Lerp(q2, q3, lattice.v), lattice.w);
+}
+
+#endif // MAP_NOISE_CACHE_HPP
@@ -1,29 +1,34 @@
 #include "plot.hpp"
+#include "../Utils/frame_arena.hpp"
 
 PlotOnMap::PlotOnMap() {
+    setupMarker();
+}
+
+void PlotOnMap::setupMarker() {
+    marker.setRadius(5);
+    marker.setFillColor(sf::Color::Red);
+    marker.setOutlineColor(sf::Color::Black);
+    marker.setOutlineThickness(1);
 }
 
 void PlotOnMap::draw(sf::RenderWindow& window, float zoomFactor) {
     if (!togglePlotMap) {
         return;
     }
-    // draw the coordinates on the map
-    for (const auto& coordinate : coordinates) {
-        sf::CircleShape circle(5);
-        circle.setPosition(coordinate.x, coordinate.y);
-        circle.setFillColor(sf::Color::Red);
-        circle.setOutlineColor(sf::Color::Black);
-        circle.setOutlineThickness(1);
-        circle.setRadius(5);
-        // make a line and its previous point
-        if (coordinates.size() > 1) {
-            sf::Vertex line[] = {
-                sf::Vertex(coordinates[coordinates.size() - 2], sf::Color::Red),
-                sf::Vertex(coordinate, sf::Color::Red)
-            };
-            window.draw(line, 2, sf::Lines);
+    // Connect the coordinates in order, the line only lives for this frame
+    if (coordinates.size() > 1) {
+        FrameVector<sf::Vertex> path;
+        path.reserve(coordinates.size());
+        for (const auto& coordinate : coordinates) {
+            path.emplace_back(coordinate, sf::Color::Red);
         }
-        window.draw(circle);
+        window.draw(path.data(), path.size(), sf::LineStrip);
+    }
+    // One marker shape is moved from point to point
+    for (const auto& coordinate : coordinates) {
+        marker.setPosition(coordinate.x, coordinate.y);
+        window.draw(marker);
     }
 }
 
@@ -41,6 +46,7 @@ void PlotOnMap::clearCoordinates() {
 
 PlotOnMap::PlotOnMap(std::vector<sf::Vector2f> coordinates) {
     this->coordinates = coordinates;
+    setupMarker();
 }
 
 void PlotOnMap::saveCoordinates(const std::string& filename, std::string countryName) {
@@ -30,6 +30,9 @@ public:
 private:
     std::vector<sf::Vector2f> coordinates;
     std::string countryName;
+    sf::CircleShape marker;
+
+    void setupMarker();
 };
 
 #endif // MAP_PLOT_HPP
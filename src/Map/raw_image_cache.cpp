@@ -0,0 +1,154 @@
+#include "raw_image_cache.hpp"
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+constexpr char RAW_IMAGE_MAGIC[4] = {'R', 'G', 'B', 'A'};
+constexpr std::uint32_t RAW_IMAGE_VERSION = 2;
+
+static_assert(sizeof(RawImageHeader) == 40, "RawImageHeader is written as is");
+
+// Size and modification time from the file system, without reading the file
+bool getSourceStamp(const std::string& path, std::uint64_t& size, std::int64_t& time) {
+    std::error_code error;
+    size = std::filesystem::file_size(path, error);
+    if (error) {
+        return false;
+    }
+    time = static_cast<std::int64_t>(std::filesystem::last_write_time(path, error).time_since_epoch().count());
+    return !error;
+}
+
+// Rewrites only the stored modification time of an existing cache, in place
+bool writeSourceTime(const std::string& cachePath, std::int64_t time) {
+    std::fstream file(cachePath, std::ios::binary | std::ios::in | std::ios::out);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.seekp(offsetof(RawImageHeader, sourceTime));
+    file.write(reinterpret_cast<const char*>(&time), sizeof(time));
+    return static_cast<bool>(file);
+}
+
+} // namespace
+
+std::string RawImageCache::getCachePath(const std::string& sourcePath) {
+    return sourcePath + ".rgba";
+}
+
+bool RawImageCache::hashFile(const std::string& path, std::uint64_t& hash, std::uint64_t& size) {
+    MappedFile source;
+    if (!source.open(path)) {
+        return false;
+    }
+
+    const std::uint64_t prime = 0x100000001b3ull;
+    hash = 0xcbf29ce484222325ull;
+    size = source.getSize();
+
+    const std::uint8_t* data = source.getData();
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * prime;
+    }
+    for (; i < size; i++) {
+        hash = (hash ^ data[i]) * prime;
+    }
+    return true;
+}
+
+bool RawImageCache::write(const std::string& sourcePath, const sf::Image& image) {
+    RawImageHeader header{};
+    std::memcpy(header.magic, RAW_IMAGE_MAGIC, sizeof(header.magic));
+    header.version = RAW_IMAGE_VERSION;
+    header.width = image.getSize().x;
+    header.height = image.getSize().y;
+    // Stamped before hashing, a source changed in between fails the time check and gets hashed again
+    if (!getSourceStamp(sourcePath, header.sourceSize, header.sourceTime)
+        || !hashFile(sourcePath, header.sourceHash, header.sourceSize)) {
+        return false;
+    }
+
+    // Written under a temporary name so a reader never maps a half written cache
+    const std::string cachePath = getCachePath(sourcePath);
+    const std::string temporaryPath = cachePath + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Failed to write image cache: " << cachePath << std::endl;
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(image.getPixelsPtr()), static_cast<std::streamsize>(header.width) * header.height * 4);
+        if (!file) {
+            std::cerr << "Failed to write image cache: " << cachePath << std::endl;
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, cachePath, error);
+    if (error) {
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+    return true;
+}
+
+bool RawImageCache::open(const std::string& sourcePath) {
+    close();
+    if (!file.open(getCachePath(sourcePath)) || file.getSize() < sizeof(RawImageHeader)) {
+        close();
+        return false;
+    }
+    std::memcpy(&header, file.getData(), sizeof(header));
+
+    std::uint64_t sourceSize = 0;
+    std::int64_t sourceTime = 0;
+    bool valid = std::memcmp(header.magic, RAW_IMAGE_MAGIC, sizeof(header.magic)) == 0
+        && header.version == RAW_IMAGE_VERSION
+        && file.getSize() == sizeof(RawImageHeader) + static_cast<std::size_t>(header.width) * header.height * 4
+        && getSourceStamp(sourcePath, sourceSize, sourceTime)
+        && sourceSize == header.sourceSize;
+    // Same size and time is taken as unchanged, a touched source is compared by content
+    if (valid && sourceTime != header.sourceTime) {
+        std::uint64_t sourceHash = 0;
+        valid = hashFile(sourcePath, sourceHash, sourceSize) && sourceSize == header.sourceSize && sourceHash == header.sourceHash;
+        // Same content, store the new time so later runs skip the hash. The time was taken before
+        // hashing, so a source changed in between is still hashed next time. The mapping is dropped
+        // while the header is written, Windows refuses writes to a file it has mapped for reading
+        if (valid) {
+            const std::size_t cacheSize = file.getSize();
+            file.close();
+            writeSourceTime(getCachePath(sourcePath), sourceTime);
+            valid = file.open(getCachePath(sourcePath)) && file.getSize() == cacheSize;
+            if (valid) {
+                std::memcpy(&header, file.getData(), sizeof(header));
+            }
+        }
+    }
+    if (!valid) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void RawImageCache::close() {
+    file.close();
+    header = RawImageHeader{};
+}
+
+sf::Vector2u RawImageCache::getSize() const {
+    return sf::Vector2u(header.width, header.height);
+}
+
+const sf::Uint8* RawImageCache::getPixels() const {
+    return file.isOpen() ? file.getData() + sizeof(RawImageHeader) : nullptr;
+}
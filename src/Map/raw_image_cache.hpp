@@ -0,0 +1,45 @@
+#ifndef MAP_RAW_IMAGE_CACHE_HPP
+#define MAP_RAW_IMAGE_CACHE_HPP
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <string>
+#include "../Utils/mapped_file.hpp"
+
+// Fixed-size header in front of the RGBA rows, native byte order
+struct RawImageHeader {
+    char magic[4];              // "RGBA"
+    std::uint32_t version;
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint64_t sourceSize;   // size, modification time and hash of the file the pixels were
+    std::int64_t sourceTime;    // decoded from, a cache whose source changed is ignored
+    std::uint64_t sourceHash;
+};
+
+// Decoded pixels of an image kept next to it as <source>.rgba, so later runs map them
+// instead of decoding the PNG again
+class RawImageCache {
+public:
+    static std::string getCachePath(const std::string& sourcePath);
+
+    // FNV-1a over 64-bit words of the mapped file, the tail byte by byte
+    static bool hashFile(const std::string& path, std::uint64_t& hash, std::uint64_t& size);
+
+    // Writes the cache for sourcePath, replacing any previous one
+    static bool write(const std::string& sourcePath, const sf::Image& image);
+
+    // Maps the cache of sourcePath, false when it is missing or stale. The source is only hashed
+    // when its modification time no longer matches, an unchanged hash stores the new time
+    bool open(const std::string& sourcePath);
+    void close();
+
+    sf::Vector2u getSize() const;
+    const sf::Uint8* getPixels() const;
+
+private:
+    MappedFile file;
+    RawImageHeader header{};
+};
+
+#endif // MAP_RAW_IMAGE_CACHE_HPP
@@ -1,24 +1,62 @@
 #include "renderer.hpp"
+#include "../Utils/frame_arena.hpp"
+#include <cstring>
+#include <limits>
+
+namespace {
+
+// Metre based projections (EPSG:3395) get centimetre steps, degrees get 1e-6, which is exact for the
+// six decimal Natural Earth exports. A declared CRS decides, otherwise the extent of every coordinate
+// does: no longitude or latitude reaches past 360
+double selectQuantum(const json& geojson) {
+    if (geojson.contains("crs") && geojson["crs"].contains("properties") && geojson["crs"]["properties"].contains("name")) {
+        const std::string name = geojson["crs"]["properties"]["name"].get<std::string>();
+        for (const char* geographic : {"CRS84", "CRS83", "CRS27", ":4326", ":4269", ":4258"}) {
+            const std::size_t at = name.rfind(geographic);
+            if (at != std::string::npos && at + std::strlen(geographic) == name.size()) {
+                return 1e-6;
+            }
+        }
+        return 1e-2;
+    }
+
+    double magnitude = 0.0;
+    const auto measurePolygon = [&magnitude](const json& polygon) {
+        for (const auto& ring : polygon) {
+            for (const auto& point : ring) {
+                magnitude = std::max({magnitude, std::abs(point[0].get<double>()), std::abs(point[1].get<double>())});
+            }
+        }
+    };
+    for (const auto& feature : geojson["features"]) {
+        const auto& geometry = feature["geometry"];
+        if (geometry["type"] == "Polygon") {
+            measurePolygon(geometry["coordinates"]);
+        } else if (geometry["type"] == "MultiPolygon") {
+            for (const auto& polygon : geometry["coordinates"]) {
+                measurePolygon(polygon);
+            }
+        }
+    }
+    return magnitude > 360.0 ? 1e-2 : 1e-6;
+}
+
+} // namespace
 
 void MapRenderer::calculateBounds() {
-    if (polygons.empty()) return;
-    
-    // Initialize bounds with first coordinate
-    const auto& firstPolygon = polygons[0];
-    const auto& firstPoint = firstPolygon[0];
-    minBounds = sf::Vector2f(firstPoint.position.x, firstPoint.position.y);
-    maxBounds = sf::Vector2f(firstPoint.position.x, firstPoint.position.y);
-    
+    if (geometry.getTotalPointCount() == 0) return;
+
+    minBounds = sf::Vector2<double>(std::numeric_limits<double>::max(), std::numeric_limits<double>::max());
+    maxBounds = sf::Vector2<double>(std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest());
+
     // Single pass bounds calculation
-    #pragma omp parallel for reduction(min:minBounds.x,minBounds.y) reduction(max:maxBounds.x,maxBounds.y)
-    for (size_t i = 0; i < polygons.size(); i++) {
-        for (size_t j = 0; j < polygons[i].getVertexCount(); j++) {
-            const auto& coord = polygons[i][j];
-            minBounds.x = std::min(minBounds.x, static_cast<decltype(minBounds.x)>(coord.position.x));
-            maxBounds.x = std::max(maxBounds.x, static_cast<decltype(maxBounds.x)>(coord.position.x));
-            minBounds.y = std::min(minBounds.y, static_cast<decltype(minBounds.y)>(coord.position.y));
-            maxBounds.y = std::max(maxBounds.y, static_cast<decltype(maxBounds.y)>(coord.position.y));
-        }
+    for (size_t i = 0; i < geometry.getRingCount(); i++) {
+        geometry.forEachPoint(i, [this](double x, double y) {
+            minBounds.x = std::min(minBounds.x, x);
+            maxBounds.x = std::max(maxBounds.x, x);
+            minBounds.y = std::min(minBounds.y, y);
+            maxBounds.y = std::max(maxBounds.y, y);
+        });
     }
 }
 
@@ -41,18 +79,19 @@ void MapRenderer::calculateScaleAndOffset(const sf::Vector2u& windowSize, float
 
 
 
-MapRenderer::MapRenderer(const std::string& filename, ProgressBar& progressBar) : filename(filename) {
+MapRenderer::MapRenderer(const std::string& filename) : filename(filename) {
     // Reserve space for large datasets
     colors.reserve(1000);
-    
-    font.loadFromFile("res/font/arial.TTF");
+}
 
-    // async load the geojson file
-    std::thread loadThread([this, &progressBar]() {
-        loadFromGeoJSON();
-        progressBar.incrementProgress();
-    });
-    loadThread.join();
+MapRenderer::MapRenderer(const std::string& filename, ProgressBar& progressBar) : MapRenderer(filename) {
+    loadFont();
+    loadFromGeoJSON();
+    progressBar.incrementProgress();
+}
+
+bool MapRenderer::loadFont() {
+    return font.loadFromFile("res/font/arial.TTF");
 }
 
 void MapRenderer::loadFromGeoJSON() {
@@ -73,10 +112,10 @@ void MapRenderer::loadFromGeoJSON() {
     }
 
     const auto& features = geojsonData["features"];
-    polygons.reserve(features.size() * 2); // Reserve estimated space
     colors.reserve(features.size() * 2);
 
-    #pragma omp parallel for
+    geometry = GeometryStore(selectQuantum(geojsonData));
+
     for (size_t i = 0; i < features.size(); i++) {
         const auto& feature = features[i];
         std::string name;
@@ -88,138 +127,249 @@ void MapRenderer::loadFromGeoJSON() {
             name = "Unknown_" + std::to_string(i); // Assign a unique placeholder name
         }
 
-        const auto& geometry = feature["geometry"];
-        const std::string& geomType = geometry["type"];
+        const auto& geometryJson = feature["geometry"];
+        const std::string& geomType = geometryJson["type"];
 
         if (geomType == "Polygon") {
-            #pragma omp critical
-            addPolygon(geometry["coordinates"]);
+            const auto& firstPoint = geometryJson["coordinates"][0][0];
+            geometry.beginFeature(firstPoint[0].get<double>(), firstPoint[1].get<double>());
+            addPolygon(geometryJson["coordinates"]);
+            colors.push_back(sf::Color(dis(gen), dis(gen), dis(gen), 50));
+            names.push_back(name);
+            polygonFeatures.push_back(i);
         } else if (geomType == "MultiPolygon") {
-            for (const auto& polygon : geometry["coordinates"]) {
-                #pragma omp critical
+            const auto& firstPoint = geometryJson["coordinates"][0][0][0];
+            geometry.beginFeature(firstPoint[0].get<double>(), firstPoint[1].get<double>());
+            for (const auto& polygon : geometryJson["coordinates"]) {
                 addPolygon(polygon);
                 colors.push_back(sf::Color(dis(gen), dis(gen), dis(gen), 50));
                 names.push_back(name);
+                polygonFeatures.push_back(i);
             }
         }
     }
-}
 
-void MapRenderer::addPolygon(const json& coordinates) {
-    sf::ConvexShape polygon;
-    const auto& points = coordinates[0];
-    polygon.setPointCount(points.size());
-    
-    for (size_t i = 0; i < points.size(); i++) {
-        polygon.setPoint(i, sf::Vector2f(
-            points[i][0].get<double>(),
-            points[i][1].get<double>()
-        ));
-    }
-    // Convert sf::ConvexShape to sf::VertexArray
-    sf::VertexArray vertexArray(sf::TrianglesFan, polygon.getPointCount());
-    for (size_t i = 0; i < polygon.getPointCount(); ++i) {
-        vertexArray[i].position = polygon.getPoint(i);
-        vertexArray[i].color = sf::Color::White; // or any default color
-    }
+    geometry.shrinkToFit();
+    calculateBounds();
+
+    // Labels, bounds and simplification work on a temporary float copy relative to minBounds,
+    // only the compact store is kept afterwards
+    const std::vector<sf::VertexArray> localRings = decodeLocalRings();
 
-    // make the last point the same as the first point to close the shape
-    vertexArray[vertexArray.getVertexCount() - 1].position = vertexArray[0].position;
-    vertexArray[vertexArray.getVertexCount() - 1].color = vertexArray[0].color;
-    polygons.push_back(std::move(vertexArray));
+    // Anchors and glyph layouts are computed once here instead of every frame
+    labels.build(localRings, names, font);
+    calculatePolygonBounds(localRings);
+    buildBorderLevels(localRings);
 }
 
-sf::Vector2f MapRenderer::calculateCentroid(std::vector<sf::Vector2f>& coordinates) {
-    float sumX = 0.0f;
-    float sumY = 0.0f;
-    for (const auto& coord : coordinates) {
-        sumX += coord.x;
-        sumY += coord.y;
+std::vector<sf::VertexArray> MapRenderer::decodeLocalRings() const {
+    std::vector<sf::VertexArray> localRings(geometry.getRingCount(), sf::VertexArray(sf::LineStrip));
+    for (size_t i = 0; i < geometry.getRingCount(); i++) {
+        sf::VertexArray& ring = localRings[i];
+        ring.resize(geometry.getPointCount(i));
+        size_t j = 0;
+        geometry.forEachPoint(i, [&](double x, double y) {
+            ring[j++].position = sf::Vector2f(static_cast<float>(x - minBounds.x), static_cast<float>(y - minBounds.y));
+        });
     }
-    float centerX = sumX / coordinates.size();
-    float centerY = sumY / coordinates.size();
-    return sf::Vector2f(centerX, centerY);
+    return localRings;
 }
 
+void MapRenderer::calculatePolygonBounds(const std::vector<sf::VertexArray>& localRings) {
+    polygonBounds.assign(localRings.size(), sf::FloatRect());
+    featureBounds.clear();
 
+    for (size_t i = 0; i < localRings.size(); i++) {
+        const auto& polygon = localRings[i];
+        if (polygon.getVertexCount() == 0) {
+            continue;
+        }
+        sf::Vector2f low = polygon[0].position;
+        sf::Vector2f high = polygon[0].position;
+        for (size_t j = 1; j < polygon.getVertexCount(); j++) {
+            const sf::Vector2f& position = polygon[j].position;
+            low.x = std::min(low.x, position.x);
+            low.y = std::min(low.y, position.y);
+            high.x = std::max(high.x, position.x);
+            high.y = std::max(high.y, position.y);
+        }
+        polygonBounds[i] = sf::FloatRect(low, high - low);
 
-void MapRenderer::draw(sf::RenderWindow& window, float zoomFactor, const RendererSettings& rendererSettings, const sf::Vector2u& textureSize) {
-    calculateScaleAndOffset(window.getSize(), zoomFactor, textureSize);
-
-    // Create vertex arrays for batch rendering
-    sf::VertexArray vertexArray(sf::Triangles);
-
-    // Initialize countryNames only if toggleNames is true
-    std::vector<sf::Text> countryNames;
-    if (toggleNames) {
-        countryNames.resize(polygons.size());
+        // Feature bounds are the union of their rings
+        const size_t feature = polygonFeatures[i];
+        if (feature >= featureBounds.size()) {
+            featureBounds.resize(feature + 1, sf::FloatRect(0.0f, 0.0f, -1.0f, -1.0f));
+        }
+        sf::FloatRect& bounds = featureBounds[feature];
+        if (bounds.width < 0.0f) {
+            bounds = polygonBounds[i];
+        } else {
+            const float right = std::max(bounds.left + bounds.width, high.x);
+            const float bottom = std::max(bounds.top + bounds.height, high.y);
+            bounds.left = std::min(bounds.left, low.x);
+            bounds.top = std::min(bounds.top, low.y);
+            bounds.width = right - bounds.left;
+            bounds.height = bottom - bounds.top;
+        }
     }
+}
 
-    // Loop through each polygon and add vertices to a single vertex array
-    for (size_t i = 0; i < polygons.size(); i++) {
-        const auto& polygon = polygons[i];
-        const sf::Color color = colors[i];
-
-        if (toggleNames) {
-            // Check if name is valid and handle empty names
-            std::string displayName = (i < names.size() && !names[i].empty()) ? names[i] : "Unknown";
-            countryNames[i] = sf::Text(displayName, font);
-
-            // Create a vector of coordinates from the polygon points
-            std::vector<sf::Vector2f> coordinates;
-            for (size_t k = 0; k < polygon.getVertexCount(); ++k) {
-                coordinates.push_back(polygon[k].position);
+void MapRenderer::buildBorderLevels(const std::vector<sf::VertexArray>& localRings) {
+    // Tolerances are multiples of one screen pixel when the whole map fits a 1920px window
+    const double pixelAtFit = std::max(maxBounds.x - minBounds.x, maxBounds.y - minBounds.y) / 1920.0;
+    std::vector<double> tolerances;
+    for (double multiple : {0.25, 0.5, 1.0, 2.0, 4.0, 8.0}) {
+        tolerances.push_back(pixelAtFit * multiple);
+    }
+    borderSimplifier = BorderSimplifier(tolerances);
+    const std::vector<SimplifiedRing> simplified = borderSimplifier.build(localRings);
+
+    // Each level is its own compact store, copied from the exact source coordinates
+    borderLevels.assign(tolerances.size(), GeometryStore(geometry.getQuantum()));
+    std::vector<double> source;
+    std::vector<double> kept;
+    for (size_t i = 0; i < geometry.getRingCount(); i++) {
+        source.clear();
+        geometry.forEachPoint(i, [&source](double x, double y) {
+            source.push_back(x);
+            source.push_back(y);
+        });
+
+        const bool newFeature = i == 0 || polygonFeatures[i] != polygonFeatures[i - 1];
+        for (size_t level = 0; level < borderLevels.size(); level++) {
+            if (newFeature && !source.empty()) {
+                borderLevels[level].beginFeature(source[0], source[1]);
+            }
+            kept.clear();
+            for (std::uint32_t index : simplified[i].levels[level]) {
+                kept.push_back(source[index * 2]);
+                kept.push_back(source[index * 2 + 1]);
             }
+            borderLevels[level].addRing(kept.data(), kept.size() / 2);
+        }
+    }
+    for (auto& level : borderLevels) {
+        level.shrinkToFit();
+    }
+}
 
-            // Calculate the centroid of the polygon for positioning
-            sf::Vector2f centroid = calculateCentroid(coordinates);
+void MapRenderer::addPolygon(const json& coordinates) {
+    const auto& points = coordinates[0];
+    ringScratch.clear();
+    ringScratch.reserve(points.size() * 2);
+    for (const auto& point : points) {
+        ringScratch.push_back(point[0].get<double>());
+        ringScratch.push_back(point[1].get<double>());
+    }
+    geometry.addRing(ringScratch.data(), points.size());
+}
 
-            // Calculate bounding box size of the polygon for scaling the text
-            float polygonWidth = maxBounds.x - minBounds.x;
-            float polygonHeight = maxBounds.y - minBounds.y;
-            float minDimension = std::min(polygonWidth, polygonHeight);
+sf::Transform MapRenderer::getMapTransform(const RendererSettings& rendererSettings) const {
+    // Map space relative to minBounds to screen space, flipping y so north is up
+    const float scaleX = static_cast<float>(rendererSettings.scale.x + scale);
+    const float scaleY = static_cast<float>(rendererSettings.scale.y + scale);
+    const float offsetX = rendererSettings.offset.x + offset.x;
+    const float offsetY = rendererSettings.offset.y + offset.y;
+    const float height = static_cast<float>(maxBounds.y - minBounds.y);
+    return sf::Transform(
+        scaleX, 0.0f, offsetX,
+        0.0f, -scaleY, offsetY + height * scaleY,
+        0.0f, 0.0f, 1.0f
+    );
+}
 
-            // Set text origin to its center for accurate centering
-            countryNames[i].setOrigin(countryNames[i].getLocalBounds().width / 2.0f, countryNames[i].getLocalBounds().height / 2.0f);
-            countryNames[i].setCharacterSize(static_cast<unsigned int>(minDimension / 5) + rendererSettings.fontSize); // Adjust divisor as needed
+void MapRenderer::draw(sf::RenderTarget& window, float zoomFactor, const RendererSettings& rendererSettings, const sf::Vector2u& textureSize, const sf::Vector2u& fitSize) {
+    calculateScaleAndOffset(fitSize.x > 0 && fitSize.y > 0 ? fitSize : window.getSize(), zoomFactor, textureSize);
 
-            countryNames[i].setPosition(
-                static_cast<float>((centroid.x - minBounds.x) * (rendererSettings.scale.x + scale) + (rendererSettings.offset.x + offset.x)),
-                static_cast<float>((maxBounds.y - centroid.y) * (rendererSettings.scale.y + scale) + (rendererSettings.offset.y + offset.y))
-            );
-            countryNames[i].setFillColor(sf::Color(rendererSettings.fontColor[0] * 255, rendererSettings.fontColor[1] * 255, rendererSettings.fontColor[2] * 255));
-            countryNames[i].setOutlineColor(sf::Color::Black);
-            countryNames[i].setOutlineThickness(1.0f);
+    // Bring the current view into map space once, everything outside it is skipped
+    const sf::Transform mapTransform = getMapTransform(rendererSettings);
+    const sf::View& view = window.getView();
+    const sf::FloatRect viewRect(view.getCenter() - view.getSize() / 2.0f, view.getSize());
+    const sf::FloatRect mapViewRect = mapTransform.getInverse().transformRect(viewRect);
 
-        }
+    if (toggleNames) {
+        // Character size is derived from the whole map extent, as before
+        float minDimension = std::min(maxBounds.x - minBounds.x, maxBounds.y - minBounds.y);
+        unsigned int characterSize = static_cast<unsigned int>(minDimension / 5 + rendererSettings.fontSize);
+        sf::Color fontColor(rendererSettings.fontColor[0] * 255, rendererSettings.fontColor[1] * 255, rendererSettings.fontColor[2] * 255);
 
+        labels.layout(mapTransform, characterSize, fontColor);
+        labels.draw(window);
     }
 
-
-    // Only draw country names if toggleNames is true
-    if (toggleNames) {
-        for (const auto& name : countryNames) {
-            window.draw(name);
+    // Pick the border detail from how many map units one screen pixel covers
+    const float pixelsPerViewUnit = static_cast<float>(window.getSize().x) / window.getView().getSize().x;
+    const double mapUnitsPerPixel = 1.0 / ((rendererSettings.scale.x + scale) * pixelsPerViewUnit);
+    const std::size_t level = borderLevels.empty() ? 0 : borderSimplifier.selectLevel(mapUnitsPerPixel);
+    const GeometryStore& store = level > 0 ? borderLevels[level - 1] : geometry;
+
+    // Full detail comes from the tile pyramid when one is open, the resident copy was dropped
+    visiblePolygonCount = 0;
+    if (level == 0 && vectorTiles.isOpen()) {
+        const sf::Rect<double> tileViewRect(mapViewRect.left + minBounds.x, mapViewRect.top + minBounds.y, mapViewRect.width, mapViewRect.height);
+        vectorTiles.update();
+        vectorTiles.request(tileViewRect, vectorTiles.selectZoom(mapUnitsPerPixel), drawableTiles);
+        for (size_t i = 0; i < polygonBounds.size(); i++) {
+            visiblePolygonCount += !cullToView || polygonBounds[i].intersects(mapViewRect) ? 1 : 0;
+        }
+        // Ancestors standing in for missing tiles reach well past the view, cull their lines like rings
+        for (const VectorTile* tile : drawableTiles) {
+            for (size_t i = 0; i < tile->lines.getRingCount(); i++) {
+                if (cullToView && !tile->lineBounds[i].intersects(tileViewRect)) {
+                    continue;
+                }
+                drawLine(window, tile->lines, i, false, rendererSettings);
+            }
         }
+        return;
     }
 
     // Draw the outline
-    for (const auto& polygon : polygons) {
-        sf::VertexArray outline(sf::LineStrip, polygon.getVertexCount() + 1);
-        for (size_t j = 0; j < polygon.getVertexCount(); j++) {
-            outline[j].position = sf::Vector2f(
-                static_cast<float>((polygon[j].position.x - minBounds.x) * (rendererSettings.scale.x + scale) + (rendererSettings.offset.x + offset.x)),
-                static_cast<float>((maxBounds.y -polygon[j].position.y) * (rendererSettings.scale.y + scale) + (rendererSettings.offset.y + offset.y))
-            );
-            outline[j].color = sf::Color::Black; // Outline color
+    for (size_t i = 0; i < store.getRingCount(); i++) {
+        if (cullToView && !polygonBounds.empty()
+            && (!featureBounds[polygonFeatures[i]].intersects(mapViewRect) || !polygonBounds[i].intersects(mapViewRect))) {
+            continue;
         }
-        outline[polygon.getVertexCount()].position = outline[0].position;
-        outline[polygon.getVertexCount()].color = sf::Color::Black;
+        ++visiblePolygonCount;
+        drawLine(window, store, i, true, rendererSettings);
+    }
+}
+
+void MapRenderer::drawLine(sf::RenderTarget& target, const GeometryStore& store, std::size_t index, bool closed, const RendererSettings& rendererSettings) {
+    const size_t count = store.getPointCount(index);
+    if (count == 0) {
+        return;
+    }
 
-        window.draw(outline);
+    // Decode straight into screen space in double precision, the vertices only live for this frame
+    FrameVector<sf::Vertex> outline(closed ? count + 1 : count);
+    size_t j = 0;
+    store.forEachPoint(index, [&](double x, double y) {
+        outline[j].position = sf::Vector2f(
+            static_cast<float>((x - minBounds.x) * (rendererSettings.scale.x + scale) + (rendererSettings.offset.x + offset.x)),
+            static_cast<float>((maxBounds.y - y) * (rendererSettings.scale.y + scale) + (rendererSettings.offset.y + offset.y))
+        );
+        outline[j].color = sf::Color::Black; // Outline color
+        ++j;
+    });
+    if (closed) {
+        outline[count].position = outline[0].position;
+        outline[count].color = sf::Color::Black;
     }
+
+    target.draw(outline.data(), outline.size(), sf::LineStrip);
 }
 
+bool MapRenderer::setVectorTiles(const std::string& directory) {
+    if (!vectorTiles.open(directory, geometry.getQuantum())) {
+        return false;
+    }
+
+    // Bounds, labels and the simplified levels are already built, the full detail rings are not needed anymore
+    geometry.clear();
+    geometry.shrinkToFit();
+    return true;
+}
 
 void MapRenderer::update(const sf::Vector2f& mousePos, sf::RenderWindow& window, MapDrawTexture& mapDrawTexture) {
     // Convert mouse position to world coordinates considering scale and offset
@@ -266,4 +416,70 @@ void MapRenderer::updateSelectedColor(const sf::Color& color) {
             break;
         }
     }
-}
\ No newline at end of file
+}
+
+std::size_t MapRenderer::getVisibleLabelCount() const {
+    return toggleNames ? labels.getVisibleCount() : 0;
+}
+
+sf::Time MapRenderer::getLabelLayoutTime() const {
+    return toggleNames ? labels.getLayoutTime() : sf::Time::Zero;
+}
+
+std::size_t MapRenderer::getVisiblePolygonCount() const {
+    return visiblePolygonCount;
+}
+
+std::size_t MapRenderer::getPolygonCount() const {
+    return polygonFeatures.size();
+}
+
+std::size_t MapRenderer::getPointCount() const {
+    // With a tile pyramid open the full detail points are only those of the resident tiles
+    return vectorTiles.isOpen() ? vectorTiles.getPointCount() : geometry.getTotalPointCount();
+}
+
+std::size_t MapRenderer::getGeometryMemoryUsage() const {
+    std::size_t bytes = geometry.getMemoryUsage() + vectorTiles.getMemoryUsage();
+    for (const auto& level : borderLevels) {
+        bytes += level.getMemoryUsage();
+    }
+    return bytes;
+}
+
+void MapRenderer::reportMemory(MemoryRegistry& registry) const {
+    // A geometry store is three vectors: origins, rings and the point stream
+    registry.report("borders.geometry", {geometry.getMemoryUsage(), geometry.getRingCount() > 0 ? 3u : 0u});
+
+    MemoryUsage levels = measureMemory(borderLevels);
+    for (const auto& level : borderLevels) {
+        levels += {level.getMemoryUsage() - sizeof(level), 3};
+    }
+    registry.report("borders.levels", levels);
+
+    MemoryUsage bounds = measureMemory(polygonBounds);
+    bounds += measureMemory(featureBounds);
+    bounds += measureMemory(polygonFeatures);
+    registry.report("borders.bounds", bounds);
+
+    MemoryUsage countryNames = measureMemory(names);
+    const std::size_t inlineCapacity = std::string().capacity();
+    for (const auto& name : names) {
+        // Short names live inside the string itself
+        if (name.capacity() > inlineCapacity) {
+            countryNames += {name.capacity() + 1, 1};
+        }
+    }
+    countryNames += measureMemory(colors);
+    registry.report("borders.names", countryNames);
+
+    registry.report("borders.tiles", {vectorTiles.getMemoryUsage(), vectorTiles.getResidentCount() * 3});
+}
+
+std::size_t MapRenderer::getResidentTileCount() const {
+    return vectorTiles.getResidentCount();
+}
+
+std::size_t MapRenderer::getPendingTileCount() const {
+    return vectorTiles.getPendingCount();
+}
@@ -11,8 +11,13 @@
 #include <future>
 #include <random>
 #include <iostream>
+#include "../Utils/memory_registry.hpp"
 #include "../Utils/progressbar.hpp"
 #include "map_texture.hpp"
+#include "labels.hpp"
+#include "simplify.hpp"
+#include "geometry_store.hpp"
+#include "vector_tiles.hpp"
 
 #define DEBUG_MAP_RENDERER
 
@@ -33,30 +38,64 @@ class MapRenderer {
 private:
     std::string selectedCountry;
     std::vector<std::string> names;
-    std::vector<sf::VertexArray> polygons;
-    sf::Vector2f minBounds, maxBounds;
+    GeometryStore geometry;                      // one ring per polygon, quantised map coordinates
+    std::vector<std::size_t> polygonFeatures;    // feature index of each polygon ring
+    std::vector<sf::FloatRect> polygonBounds;    // bounds of each ring, relative to minBounds
+    std::vector<sf::FloatRect> featureBounds;    // bounds of each feature's rings, relative to minBounds
+    std::size_t visiblePolygonCount = 0;
+    sf::Vector2<double> minBounds, maxBounds;
     double scale;
     sf::Vector2f offset;
     std::vector<sf::Color> colors;
     std::string filename;
     sf::Font font;
+    LabelLayer labels;
+    BorderSimplifier borderSimplifier;
+    std::vector<GeometryStore> borderLevels;     // simplified copies of geometry, level 1 first
+    std::vector<double> ringScratch;
+    VectorTileCache vectorTiles;                 // full detail borders, streamed instead of kept resident
+    std::vector<const VectorTile*> drawableTiles;
 
     void calculateScaleAndOffset(const sf::Vector2u& windowSize, float zoomFactor, const sf::Vector2u& textureSize);
     bool isPointInPolygon(const sf::Vector2f& point, const std::vector<sf::Vector2f>& polygon);
-    sf::Vector2f calculateCentroid(std::vector<sf::Vector2f>& coordinates);
+    sf::Transform getMapTransform(const RendererSettings& rendererSettings) const;
+    std::vector<sf::VertexArray> decodeLocalRings() const;
+    void calculatePolygonBounds(const std::vector<sf::VertexArray>& localRings);
+    void buildBorderLevels(const std::vector<sf::VertexArray>& localRings);
+    void drawLine(sf::RenderTarget& target, const GeometryStore& store, std::size_t index, bool closed, const RendererSettings& rendererSettings);
 
 public:
     bool toggleNames = false;
+    bool cullToView = true;
+    // Nothing is loaded, call loadFont() and then loadFromGeoJSON(), e.g. from loader jobs
+    explicit MapRenderer(const std::string& filename);
+    // Loads everything before returning
     MapRenderer(const std::string& filename, ProgressBar& progressBar);
 
     void calculateBounds();
+    bool loadFont();
+    // Labels are laid out with the font, load it first
     void loadFromGeoJSON();
 
     void addPolygon(const json& coordinates);
+    // Streams full detail borders from a tile pyramid and drops the resident copy
+    bool setVectorTiles(const std::string& directory);
 
-    void draw(sf::RenderWindow& window, float zoomFactor, const RendererSettings& rendererSettings, const sf::Vector2u& textureSize);
+    // The map is fitted to fitSize, the target's own size when it is zero
+    void draw(sf::RenderTarget& target, float zoomFactor, const RendererSettings& rendererSettings, const sf::Vector2u& textureSize, const sf::Vector2u& fitSize = sf::Vector2u(0, 0));
     void update(const sf::Vector2f& mousePos, sf::RenderWindow& window, MapDrawTexture& mapDrawTexture);
     void updateSelectedColor(const sf::Color& color);
+    std::size_t getVisibleLabelCount() const;
+    // Time spent placing labels in the last draw(), zero with names off
+    sf::Time getLabelLayoutTime() const;
+    std::size_t getVisiblePolygonCount() const;
+    std::size_t getPolygonCount() const;
+    std::size_t getPointCount() const;
+    std::size_t getGeometryMemoryUsage() const;
+    std::size_t getResidentTileCount() const;
+    std::size_t getPendingTileCount() const;
+    // Geometry, simplified levels, culling bounds, names and streamed tiles under "borders"
+    void reportMemory(MemoryRegistry& registry) const;
 };
 
 
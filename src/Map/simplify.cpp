@@ -0,0 +1,243 @@
+#include "simplify.hpp"
+#include "../Utils/thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+
+std::uint64_t vertexKey(const sf::Vector2f& position) {
+    std::uint32_t x, y;
+    std::memcpy(&x, &position.x, sizeof(x));
+    std::memcpy(&y, &position.y, sizeof(y));
+    return (static_cast<std::uint64_t>(x) << 32) | y;
+}
+
+std::uint64_t mixRing(std::uint64_t ring) {
+    // splitmix64 finaliser, so xor-ing ring ids gives a set signature
+    ring += 0x9E3779B97F4A7C15ull;
+    ring = (ring ^ (ring >> 30)) * 0xBF58476D1CE4E5B9ull;
+    ring = (ring ^ (ring >> 27)) * 0x94D049BB133111EBull;
+    return ring ^ (ring >> 31);
+}
+
+struct VertexShare {
+    std::uint64_t signature = 0;
+    std::size_t lastRing = static_cast<std::size_t>(-1);
+};
+
+double pointDistance(const sf::Vector2f& p, const sf::Vector2f& a) {
+    const double dx = static_cast<double>(p.x) - a.x;
+    const double dy = static_cast<double>(p.y) - a.y;
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+double segmentDistance(const sf::Vector2f& p, const sf::Vector2f& a, const sf::Vector2f& b) {
+    const double dx = static_cast<double>(b.x) - a.x;
+    const double dy = static_cast<double>(b.y) - a.y;
+    const double px = static_cast<double>(p.x) - a.x;
+    const double py = static_cast<double>(p.y) - a.y;
+    const double lengthSquared = dx * dx + dy * dy;
+    if (lengthSquared == 0.0) {
+        return pointDistance(p, a);
+    }
+    const double t = std::clamp((px * dx + py * dy) / lengthSquared, 0.0, 1.0);
+    const double ex = px - t * dx;
+    const double ey = py - t * dy;
+    return std::sqrt(ex * ex + ey * ey);
+}
+
+// Ring position farthest from origin, ties go to the smallest vertex key. Only depends on the
+// vertex positions, so every ring walking the same vertices picks the same one.
+std::uint32_t farthestVertex(const sf::VertexArray& ring, std::size_t count, const sf::Vector2f& origin) {
+    std::uint32_t farthest = 0;
+    double maxDistance = -1.0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const double distance = pointDistance(ring[i].position, origin);
+        if (distance > maxDistance || (distance == maxDistance && vertexKey(ring[i].position) < vertexKey(ring[farthest].position))) {
+            maxDistance = distance;
+            farthest = static_cast<std::uint32_t>(i);
+        }
+    }
+    return farthest;
+}
+
+// Douglas-Peucker over chain (indices into the ring), marking kept chain positions.
+// Ties go to the lowest chain position so the result only depends on chain order.
+void douglasPeucker(const sf::VertexArray& ring, const std::vector<std::uint32_t>& chain, double tolerance, std::vector<char>& keep) {
+    std::vector<std::pair<std::size_t, std::size_t>> stack;
+    stack.emplace_back(0, chain.size() - 1);
+    while (!stack.empty()) {
+        const auto [first, last] = stack.back();
+        stack.pop_back();
+        if (last <= first + 1) {
+            continue;
+        }
+
+        const sf::Vector2f& a = ring[chain[first]].position;
+        const sf::Vector2f& b = ring[chain[last]].position;
+        double maxDistance = -1.0;
+        std::size_t farthest = first;
+        for (std::size_t i = first + 1; i < last; ++i) {
+            const double distance = segmentDistance(ring[chain[i]].position, a, b);
+            if (distance > maxDistance) {
+                maxDistance = distance;
+                farthest = i;
+            }
+        }
+
+        if (maxDistance > tolerance) {
+            keep[farthest] = 1;
+            stack.emplace_back(first, farthest);
+            stack.emplace_back(farthest, last);
+        }
+    }
+}
+
+SimplifiedRing simplifyRing(const sf::VertexArray& ring, const std::vector<std::uint64_t>& signatures, const std::vector<double>& tolerances) {
+    SimplifiedRing result;
+    result.levels.resize(tolerances.size());
+
+    // Rings are closed, the duplicated last vertex is re-added at draw time
+    std::size_t count = ring.getVertexCount();
+    if (count > 1 && ring[0].position == ring[count - 1].position) {
+        --count;
+    }
+    if (count < 4) {
+        for (auto& level : result.levels) {
+            for (std::uint32_t i = 0; i < count; ++i) {
+                level.push_back(i);
+            }
+        }
+        return result;
+    }
+
+    // Pins are vertices whose sharing set differs from a neighbour's
+    std::vector<std::uint32_t> pins;
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::uint64_t previous = signatures[(i + count - 1) % count];
+        const std::uint64_t next = signatures[(i + 1) % count];
+        if (signatures[i] != previous || signatures[i] != next) {
+            pins.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+    if (pins.empty()) {
+        // Island, or an enclave whose whole ring is shared with the hole around it. Pin the vertex
+        // with the smallest key and the one farthest from it, so both rings pin the same vertices
+        std::uint32_t smallest = 0;
+        for (std::uint32_t i = 1; i < count; ++i) {
+            if (vertexKey(ring[i].position) < vertexKey(ring[smallest].position)) {
+                smallest = i;
+            }
+        }
+        pins = {smallest, farthestVertex(ring, count, ring[smallest].position)};
+        std::sort(pins.begin(), pins.end());
+    } else if (pins.size() == 1) {
+        pins.push_back(farthestVertex(ring, count, ring[pins[0]].position));
+        std::sort(pins.begin(), pins.end());
+    }
+
+    std::vector<std::uint32_t> chain;
+    std::vector<char> keep;
+    for (std::size_t level = 0; level < tolerances.size(); ++level) {
+        auto& indices = result.levels[level];
+        for (std::size_t p = 0; p < pins.size(); ++p) {
+            const std::uint32_t start = pins[p];
+            const std::uint32_t end = pins[(p + 1) % pins.size()];
+
+            chain.clear();
+            for (std::uint32_t i = start; ; i = static_cast<std::uint32_t>((i + 1) % count)) {
+                chain.push_back(i);
+                if (i == end && chain.size() > 1) {
+                    break;
+                }
+            }
+
+            // Canonical direction: the neighbour on the other side walks this chain
+            // backwards, so always simplify from the smaller endpoint key
+            const bool reversed = vertexKey(ring[chain.front()].position) > vertexKey(ring[chain.back()].position);
+            if (reversed) {
+                std::reverse(chain.begin(), chain.end());
+            }
+
+            keep.assign(chain.size(), 0);
+            keep.front() = 1;
+            keep.back() = 1;
+            douglasPeucker(ring, chain, tolerances[level], keep);
+
+            // Emit in ring order, the chain end is emitted as the next chain's start
+            if (reversed) {
+                for (std::size_t i = chain.size() - 1; i > 0; --i) {
+                    if (keep[i]) {
+                        indices.push_back(chain[i]);
+                    }
+                }
+            } else {
+                for (std::size_t i = 0; i + 1 < chain.size(); ++i) {
+                    if (keep[i]) {
+                        indices.push_back(chain[i]);
+                    }
+                }
+            }
+        }
+
+        // A ring that collapses below a triangle is too small to see at this level
+        if (indices.size() < 3) {
+            indices.clear();
+        }
+    }
+
+    return result;
+}
+
+} // namespace
+
+BorderSimplifier::BorderSimplifier(std::vector<double> tolerances) : tolerances(std::move(tolerances)) {
+    std::sort(this->tolerances.begin(), this->tolerances.end());
+}
+
+std::vector<SimplifiedRing> BorderSimplifier::build(const std::vector<sf::VertexArray>& rings) const {
+    // Which rings share each vertex, as an order independent signature
+    std::unordered_map<std::uint64_t, VertexShare> shares;
+    for (std::size_t r = 0; r < rings.size(); ++r) {
+        const std::uint64_t ringHash = mixRing(r);
+        for (std::size_t i = 0; i < rings[r].getVertexCount(); ++i) {
+            VertexShare& share = shares[vertexKey(rings[r][i].position)];
+            if (share.lastRing != r) {
+                share.signature ^= ringHash;
+                share.lastRing = r;
+            }
+        }
+    }
+
+    std::vector<SimplifiedRing> result(rings.size());
+    // Rings vary wildly in length, small chunks let idle workers pick up the rest
+    ThreadPool::global().parallelFor(0, rings.size(), 16, [&](std::size_t first, std::size_t last) {
+        std::vector<std::uint64_t> signatures;
+        for (std::size_t r = first; r < last; ++r) {
+            signatures.resize(rings[r].getVertexCount());
+            for (std::size_t i = 0; i < signatures.size(); ++i) {
+                signatures[i] = shares.find(vertexKey(rings[r][i].position))->second.signature;
+            }
+            result[r] = simplifyRing(rings[r], signatures, tolerances);
+        }
+    });
+
+    return result;
+}
+
+std::size_t BorderSimplifier::selectLevel(double mapUnitsPerPixel) const {
+    // Half a pixel of error is not visible
+    std::size_t level = 0;
+    for (std::size_t i = 0; i < tolerances.size(); ++i) {
+        if (tolerances[i] <= mapUnitsPerPixel * 0.5) {
+            level = i + 1;
+        }
+    }
+    return level;
+}
+
+std::size_t BorderSimplifier::getLevelCount() const {
+    return tolerances.size() + 1;
+}
@@ -0,0 +1,34 @@
+#ifndef MAP_SIMPLIFY_HPP
+#define MAP_SIMPLIFY_HPP
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+
+// Kept vertex indices of one ring for every simplification level.
+// Level 0 is the source ring itself, so levels[k] holds level k + 1.
+struct SimplifiedRing {
+    std::vector<std::vector<std::uint32_t>> levels;
+};
+
+class BorderSimplifier {
+public:
+    // tolerances are in map units and ascending, tolerances[0] is level 1
+    explicit BorderSimplifier(std::vector<double> tolerances = {});
+
+    // Douglas-Peucker every ring at every tolerance, rings are processed in parallel.
+    // Vertices where the set of rings sharing them changes are pinned, and every chain
+    // between pins is simplified in a canonical direction, so a border shared by two
+    // countries reduces to exactly the same vertices on both sides.
+    std::vector<SimplifiedRing> build(const std::vector<sf::VertexArray>& rings) const;
+
+    // Pick the coarsest level whose tolerance stays under the given size of a screen pixel in map units
+    std::size_t selectLevel(double mapUnitsPerPixel) const;
+
+    std::size_t getLevelCount() const;
+
+private:
+    std::vector<double> tolerances;
+};
+
+#endif // MAP_SIMPLIFY_HPP
@@ -0,0 +1,56 @@
+#include "terrain_noise.hpp"
+
+namespace {
+
+template <std::int32_t Octaves>
+void fillUnrolledColumns(const NoiseState& noise, float frequencyX, float frequencyY, int,
+    std::vector<std::vector<double>>& grid, std::size_t first, std::size_t last) {
+    for (std::size_t x = first; x < last; ++x) {
+        std::vector<double>& column = grid[x];
+        for (std::size_t y = 0; y < column.size(); ++y) {
+            const double sampleX = x * frequencyX;
+            const double sampleY = y * frequencyY;
+            column[y] = siv::perlin_detail::RemapClamp_01(siv::perlin_detail::UnrolledOctave2D<Octaves>(noise, sampleX, sampleY));
+        }
+    }
+}
+
+} // namespace
+
+void fillNoiseColumns(const NoiseState& noise, float frequencyX, float frequencyY, int octaves,
+    std::vector<std::vector<double>>& grid, std::size_t first, std::size_t last) {
+    for (std::size_t x = first; x < last; ++x) {
+        std::vector<double>& column = grid[x];
+        for (std::size_t y = 0; y < column.size(); ++y) {
+            const double sampleX = x * frequencyX;
+            const double sampleY = y * frequencyY;
+            column[y] = siv::perlin_detail::RemapClamp_01(siv::perlin_detail::Octave2D(noise, sampleX, sampleY, octaves, 0.5));
+        }
+    }
+}
+
+NoiseColumnKernel selectNoiseKernel(int octaves) {
+    switch (octaves) {
+    case 1: return fillUnrolledColumns<1>;
+    case 2: return fillUnrolledColumns<2>;
+    case 3: return fillUnrolledColumns<3>;
+    case 4: return fillUnrolledColumns<4>;
+    case 5: return fillUnrolledColumns<5>;
+    case 6: return fillUnrolledColumns<6>;
+    case 7: return fillUnrolledColumns<7>;
+    case 8: return fillUnrolledColumns<8>;
+    case 9: return fillUnrolledColumns<9>;
+    case 10: return fillUnrolledColumns<10>;
+    case 11: return fillUnrolledColumns<11>;
+    case 12: return fillUnrolledColumns<12>;
+    case 13: return fillUnrolledColumns<13>;
+    case 14: return fillUnrolledColumns<14>;
+    case 15: return fillUnrolledColumns<15>;
+    case 16: return fillUnrolledColumns<16>;
+    case 17: return fillUnrolledColumns<17>;
+    case 18: return fillUnrolledColumns<18>;
+    case 19: return fillUnrolledColumns<19>;
+    case 20: return fillUnrolledColumns<20>;
+    default: return fillNoiseColumns;
+    }
+}
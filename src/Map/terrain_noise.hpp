@@ -0,0 +1,23 @@
+#ifndef MAP_TERRAIN_NOISE_HPP
+#define MAP_TERRAIN_NOISE_HPP
+
+#include <cstddef>
+#include <vector>
+#include "noise_cache.hpp"
+
+// Octave counts from 1 up to this have an unrolled kernel, others run the library's loop
+constexpr int MAX_UNROLLED_OCTAVES = 20;
+
+// Fills columns [first, last) of grid[x][y] with octave2D_01(x * frequencyX, y * frequencyY, octaves)
+// of the seed's noise, persistence 0.5
+using NoiseColumnKernel = void (*)(const NoiseState& noise, float frequencyX, float frequencyY, int octaves,
+    std::vector<std::vector<double>>& grid, std::size_t first, std::size_t last);
+
+// The kernel unrolled for this octave count, picked once per fill instead of once per sample
+NoiseColumnKernel selectNoiseKernel(int octaves);
+
+// The runtime octave loop every count can use, for comparison
+void fillNoiseColumns(const NoiseState& noise, float frequencyX, float frequencyY, int octaves,
+    std::vector<std::vector<double>>& grid, std::size_t first, std::size_t last);
+
+#endif // MAP_TERRAIN_NOISE_HPP
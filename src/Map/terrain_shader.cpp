@@ -0,0 +1,89 @@
+#include "terrain_shader.hpp"
+#include <iostream>
+
+namespace {
+
+// GLSL 1.10 with the fixed function inputs SFML feeds every shader
+const char* VERTEX_SOURCE = R"(
+uniform float heightMultiplier;
+uniform vec3 thresholds;
+uniform vec4 topColors[4];
+uniform vec4 sideColors[4];
+uniform vec4 biomeTopColors[8];
+uniform vec4 biomeSideColors[8];
+
+void main() {
+    float height = gl_MultiTexCoord0.x;
+    vec4 position = gl_Vertex;
+    position.y -= gl_MultiTexCoord0.y * height * heightMultiplier;
+    gl_Position = gl_ModelViewProjectionMatrix * position;
+
+    int index = height < thresholds.x ? 0 : (height < thresholds.y ? 1 : (height < thresholds.z ? 2 : 3));
+    int biome = int(gl_Color.g * 255.0 + 0.5);
+    vec4 top = topColors[index];
+    vec4 side = sideColors[index];
+    if (index == 1 && biome > 0) {
+        top = biomeTopColors[biome];
+        side = biomeSideColors[biome];
+    }
+
+    int face = int(gl_Color.r * 2.0 + 0.5);
+    if (face == 1) {
+        gl_FrontColor = side;
+    } else if (face == 2) {
+        gl_FrontColor = vec4(min(top.rgb + floor(height * 50.0) / 255.0, 1.0), top.a);
+    } else {
+        gl_FrontColor = top;
+    }
+}
+)";
+
+const char* FRAGMENT_SOURCE = R"(
+void main() {
+    gl_FragColor = gl_Color;
+}
+)";
+
+} // namespace
+
+sf::Vertex TerrainShader::makeVertex(const sf::Vector2f& basePosition, double height, bool raised, Face face, Biome biome) {
+    // 0, 127 and 254 read back as face / 2 in the shader
+    const sf::Color marker(static_cast<sf::Uint8>(static_cast<int>(face) * 127), static_cast<sf::Uint8>(biome), 0);
+    return sf::Vertex(basePosition, marker, sf::Vector2f(static_cast<float>(height), raised ? 1.0f : 0.0f));
+}
+
+bool TerrainShader::load() {
+    if (!attempted) {
+        attempted = true;
+        loaded = sf::Shader::isAvailable() && shader.loadFromMemory(VERTEX_SOURCE, FRAGMENT_SOURCE);
+        if (!loaded) {
+            std::cerr << "Terrain shader unavailable, colours and heights are baked into the mesh" << std::endl;
+        }
+    }
+    return loaded;
+}
+
+void TerrainShader::setStyle(float heightMultiplier, const sf::Vector3f& thresholds, const CubePalette& palette) {
+    sf::Glsl::Vec4 topColors[CubePalette::CLASS_COUNT];
+    sf::Glsl::Vec4 sideColors[CubePalette::CLASS_COUNT];
+    for (int i = 0; i < CubePalette::CLASS_COUNT; i++) {
+        topColors[i] = sf::Glsl::Vec4(palette.top[i]);
+        sideColors[i] = sf::Glsl::Vec4(palette.side[i]);
+    }
+    sf::Glsl::Vec4 biomeTopColors[BIOME_COUNT];
+    sf::Glsl::Vec4 biomeSideColors[BIOME_COUNT];
+    for (int i = 0; i < BIOME_COUNT; i++) {
+        biomeTopColors[i] = sf::Glsl::Vec4(palette.biomeTop[i]);
+        biomeSideColors[i] = sf::Glsl::Vec4(palette.biomeSide[i]);
+    }
+    shader.setUniform("heightMultiplier", heightMultiplier);
+    shader.setUniform("thresholds", thresholds);
+    shader.setUniformArray("topColors", topColors, CubePalette::CLASS_COUNT);
+    shader.setUniformArray("sideColors", sideColors, CubePalette::CLASS_COUNT);
+    shader.setUniformArray("biomeTopColors", biomeTopColors, BIOME_COUNT);
+    shader.setUniformArray("biomeSideColors", biomeSideColors, BIOME_COUNT);
+}
+
+const sf::Shader* TerrainShader::getShader() const {
+    return loaded ? &shader : nullptr;
+}
@@ -0,0 +1,34 @@
+#ifndef MAP_TERRAIN_SHADER_HPP
+#define MAP_TERRAIN_SHADER_HPP
+
+#include <SFML/Graphics.hpp>
+#include "cube_instances.hpp"
+
+// Colours and extrudes the terrain vertex array on the GPU. Vertices carry their position at
+// height 0, the raw noise value, whether the corner is raised and the cell's biome, so the
+// thresholds, palette and height multiplier are uniforms and changing them does not touch the mesh.
+class TerrainShader {
+public:
+    // Which palette entry a vertex takes, carried in the red channel of its colour, the biome goes in green
+    enum class Face {
+        Top,
+        Side,
+        Tile    // flat map tile, the top colour brightened by height
+    };
+
+    static sf::Vertex makeVertex(const sf::Vector2f& basePosition, double height, bool raised, Face face, Biome biome);
+
+    // Compiles the shader the first time, on the main thread. False when shaders are unavailable,
+    // heights and colours then have to be baked into the vertices
+    bool load();
+    // Uniforms for the next draw
+    void setStyle(float heightMultiplier, const sf::Vector3f& thresholds, const CubePalette& palette);
+    const sf::Shader* getShader() const;
+
+private:
+    sf::Shader shader;
+    bool attempted = false;
+    bool loaded = false;
+};
+
+#endif // MAP_TERRAIN_SHADER_HPP
@@ -0,0 +1,270 @@
+#include "texture_tiles.hpp"
+#include "../Utils/frame_arena.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+TextureTileCache::TextureTileCache(std::size_t memoryBudget, std::size_t uploadBytesPerFrame)
+    : memoryBudget(memoryBudget), uploadBytesPerFrame(uploadBytesPerFrame) {}
+
+TextureTileCache::~TextureTileCache() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+bool TextureTileCache::open(const std::string& directory) {
+    std::ifstream file(directory + "/meta.json");
+    if (!file.is_open()) {
+        return false;
+    }
+
+    nlohmann::json meta = nlohmann::json::parse(file, nullptr, false);
+    if (meta.is_discarded() || !meta.contains("width") || !meta.contains("height")
+        || !meta.contains("tileSize") || !meta.contains("maxLevel")) {
+        std::cerr << "Invalid texture tile metadata in " << directory << std::endl;
+        return false;
+    }
+
+    this->directory = directory;
+    width = meta["width"].get<unsigned>();
+    height = meta["height"].get<unsigned>();
+    tileSize = meta["tileSize"].get<unsigned>();
+    maxLevel = meta["maxLevel"].get<int>();
+
+    // Loaded before anything is drawn, it stands in for every other tile
+    const TileKey root{0, 0, 0};
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!resident.count(root) && pending.insert(root).second) {
+            queue.push_back(root);
+        }
+    }
+    if (!worker.joinable()) {
+        worker = std::thread(&TextureTileCache::workerLoop, this);
+    }
+    return true;
+}
+
+bool TextureTileCache::isOpen() const {
+    return maxLevel >= 0;
+}
+
+bool TextureTileCache::isRootReady() const {
+    const TileKey root{0, 0, 0};
+    return resident.count(root) > 0 || missing.count(root) > 0;
+}
+
+sf::Vector2u TextureTileCache::getImageSize() const {
+    return sf::Vector2u(width, height);
+}
+
+int TextureTileCache::getMaxLevel() const {
+    return maxLevel;
+}
+
+int TextureTileCache::selectLevel(float screenPixelsPerImagePixel) const {
+    // A level pixel covers 2^(maxLevel - level) image pixels
+    const float level = maxLevel + std::log2(std::max(screenPixelsPerImagePixel, 1e-6f));
+    return std::clamp(static_cast<int>(std::ceil(level - 0.01f)), 0, maxLevel);
+}
+
+sf::Vector2u TextureTileCache::getLevelSize(int level) const {
+    const unsigned divisor = 1u << (maxLevel - level);
+    return sf::Vector2u((width + divisor - 1) / divisor, (height + divisor - 1) / divisor);
+}
+
+sf::FloatRect TextureTileCache::getImageRect(const TileKey& key) const {
+    const sf::Vector2u levelSize = getLevelSize(key.z);
+    const float scale = static_cast<float>(1u << (maxLevel - key.z));
+    const unsigned left = key.x * tileSize;
+    const unsigned top = key.y * tileSize;
+    const float right = std::min(std::min(left + tileSize, levelSize.x) * scale, static_cast<float>(width));
+    const float bottom = std::min(std::min(top + tileSize, levelSize.y) * scale, static_cast<float>(height));
+    return sf::FloatRect(left * scale, top * scale, right - left * scale, bottom - top * scale);
+}
+
+std::size_t TextureTileCache::getTextureBytes(const TextureTile& tile) {
+    const sf::Vector2u size = tile.texture.getSize();
+    return static_cast<std::size_t>(size.x) * size.y * 4;
+}
+
+void TextureTileCache::update() {
+    std::vector<std::pair<TileKey, std::unique_ptr<sf::Image>>> finished;
+    {
+        // Oldest decodes first, until the next one would go over this frame's upload budget
+        std::lock_guard<std::mutex> lock(mutex);
+        std::size_t count = 0;
+        std::size_t bytes = 0;
+        for (; count < completed.size(); count++) {
+            const sf::Image* image = completed[count].second.get();
+            const std::size_t imageBytes = image ? static_cast<std::size_t>(image->getSize().x) * image->getSize().y * 4 : 0;
+            if (bytes > 0 && bytes + imageBytes > uploadBytesPerFrame) {
+                break;
+            }
+            bytes += imageBytes;
+        }
+        finished.assign(std::make_move_iterator(completed.begin()), std::make_move_iterator(completed.begin() + count));
+        completed.erase(completed.begin(), completed.begin() + count);
+    }
+
+    // Textures are created here, the GL context belongs to the main thread
+    for (auto& [key, image] : finished) {
+        pending.erase(key);
+        if (!image) {
+            missing.insert(key);
+            continue;
+        }
+        lru.emplace_front();
+        TextureTile& tile = lru.front();
+        tile.key = key;
+        tile.imageRect = getImageRect(key);
+        tile.texture.loadFromImage(*image);
+        tile.texture.setSmooth(true);
+        resident[key] = lru.begin();
+        memoryUsage += getTextureBytes(tile);
+    }
+
+    auto it = lru.end();
+    while (memoryUsage > memoryBudget && it != lru.begin()) {
+        --it;
+        if (it->key.z == 0) {
+            continue;
+        }
+        memoryUsage -= getTextureBytes(*it);
+        resident.erase(it->key);
+        it = lru.erase(it);
+    }
+}
+
+void TextureTileCache::request(const sf::FloatRect& imageRect, int level, std::vector<const TextureTile*>& drawable) {
+    drawable.clear();
+    if (!isOpen()) {
+        return;
+    }
+
+    const sf::Vector2u levelSize = getLevelSize(level);
+    const float scale = static_cast<float>(1u << (maxLevel - level));
+    const int columns = static_cast<int>((levelSize.x + tileSize - 1) / tileSize);
+    const int rows = static_cast<int>((levelSize.y + tileSize - 1) / tileSize);
+    const float tileExtent = tileSize * scale;
+    const int firstX = std::clamp(static_cast<int>(std::floor(imageRect.left / tileExtent)), 0, columns - 1);
+    const int lastX = std::clamp(static_cast<int>(std::floor((imageRect.left + imageRect.width) / tileExtent)), 0, columns - 1);
+    const int firstY = std::clamp(static_cast<int>(std::floor(imageRect.top / tileExtent)), 0, rows - 1);
+    const int lastY = std::clamp(static_cast<int>(std::floor((imageRect.top + imageRect.height) / tileExtent)), 0, rows - 1);
+
+    // Every visible tile plus the root at most
+    FrameVector<TileKey> wanted;
+    wanted.reserve(static_cast<std::size_t>(lastX - firstX + 1) * (lastY - firstY + 1) + 1);
+    const auto want = [&](const TileKey& key) {
+        if (std::find(wanted.begin(), wanted.end(), key) == wanted.end()) {
+            wanted.push_back(key);
+        }
+    };
+    const auto show = [&drawable](const TextureTile* tile) {
+        if (std::find(drawable.begin(), drawable.end(), tile) == drawable.end()) {
+            drawable.push_back(tile);
+        }
+    };
+
+    for (int y = firstY; y <= lastY; y++) {
+        for (int x = firstX; x <= lastX; x++) {
+            const TileKey key{level, x, y};
+            if (missing.count(key)) {
+                continue;
+            }
+
+            auto it = resident.find(key);
+            if (it != resident.end()) {
+                lru.splice(lru.begin(), lru, it->second);
+                show(&*it->second);
+                continue;
+            }
+
+            want(key);
+
+            // Show the closest resident ancestor while this one loads, or load the root first
+            TileKey parent = key;
+            while (parent.z > 0) {
+                parent = parent.getParent();
+                auto parentIt = resident.find(parent);
+                if (parentIt != resident.end()) {
+                    show(&*parentIt->second);
+                    break;
+                }
+            }
+            if (parent.z == 0 && !resident.count(parent) && !missing.count(parent)) {
+                want(parent);
+            }
+        }
+    }
+
+    std::sort(drawable.begin(), drawable.end(), [](const TextureTile* a, const TextureTile* b) {
+        return a->key.z < b->key.z;
+    });
+
+    // Only the tiles wanted this frame stay queued, roots go first
+    std::stable_partition(wanted.begin(), wanted.end(), [](const TileKey& key) { return key.z == 0; });
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const TileKey& key : queue) {
+            pending.erase(key);
+        }
+        queue.clear();
+        for (const TileKey& key : wanted) {
+            if (pending.insert(key).second) {
+                queue.push_back(key);
+            }
+        }
+    }
+    if (!wanted.empty()) {
+        condition.notify_one();
+    }
+}
+
+std::size_t TextureTileCache::getResidentCount() const {
+    return resident.size();
+}
+
+std::size_t TextureTileCache::getPendingCount() const {
+    return pending.size();
+}
+
+std::size_t TextureTileCache::getMemoryUsage() const {
+    return memoryUsage;
+}
+
+void TextureTileCache::workerLoop() {
+    while (true) {
+        TileKey key;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this]() { return stopping || !queue.empty(); });
+            if (stopping) {
+                return;
+            }
+            key = queue.front();
+            queue.pop_front();
+        }
+
+        const std::string path = directory + "/" + std::to_string(key.z) + "/" + std::to_string(key.x) + "/" + std::to_string(key.y) + ".png";
+        std::unique_ptr<sf::Image> image;
+        if (std::ifstream(path).good()) {
+            image = std::make_unique<sf::Image>();
+            if (!image->loadFromFile(path)) {
+                image.reset();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        completed.emplace_back(key, std::move(image));
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef MAP_TEXTURE_TILES_HPP
+#define MAP_TEXTURE_TILES_HPP
+
+#include <SFML/Graphics.hpp>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "tile_key.hpp"
+
+struct TextureTile {
+    TileKey key;
+    sf::Texture texture;
+    sf::FloatRect imageRect;   // area covered, in full resolution image pixels
+};
+
+// Streams the mip pyramid written by scripts/utils/tile_pyramid.py.
+// PNGs are decoded on a background thread and uploaded on the main thread, resident tiles
+// are evicted least recently used first once their textures exceed the memory budget.
+// A tile that is not resident yet is stood in for by its nearest resident ancestor, the
+// single-tile level 0 is never evicted so there is always something to show.
+class TextureTileCache {
+public:
+    explicit TextureTileCache(std::size_t memoryBudget = 256 * 1024 * 1024, std::size_t uploadBytesPerFrame = 4 * 1024 * 1024);
+    ~TextureTileCache();
+
+    // Reads meta.json from the directory, starts the loader thread and queues the root tile
+    bool open(const std::string& directory);
+    bool isOpen() const;
+    // The root tile is resident, or missing from the pyramid so there is nothing to wait for
+    bool isRootReady() const;
+    sf::Vector2u getImageSize() const;
+    int getMaxLevel() const;
+
+    // Coarsest level whose pixels are not larger than a screen pixel
+    int selectLevel(float screenPixelsPerImagePixel) const;
+
+    // Main thread, once per frame: upload finished decodes up to the upload budget, always at least one,
+    // and evict over the memory budget. The rest stay queued for the next frames
+    void update();
+
+    // Queue the tiles covering imageRect (full resolution pixels) and collect what can be drawn now,
+    // sorted coarse to fine so finer tiles are drawn over their stand-ins
+    void request(const sf::FloatRect& imageRect, int level, std::vector<const TextureTile*>& drawable);
+
+    std::size_t getResidentCount() const;
+    std::size_t getPendingCount() const;
+    std::size_t getMemoryUsage() const;
+
+private:
+    std::string directory;
+    unsigned width = 0;
+    unsigned height = 0;
+    unsigned tileSize = 0;
+    int maxLevel = -1;
+    std::size_t memoryBudget;
+    std::size_t uploadBytesPerFrame;
+    std::size_t memoryUsage = 0;
+
+    // Main thread state, the most recently used tile is at the front
+    std::list<TextureTile> lru;
+    std::unordered_map<TileKey, std::list<TextureTile>::iterator, TileKeyHash> resident;
+    std::unordered_set<TileKey, TileKeyHash> pending;
+    std::unordered_set<TileKey, TileKeyHash> missing;
+
+    // Shared with the loader thread
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<TileKey> queue;
+    std::vector<std::pair<TileKey, std::unique_ptr<sf::Image>>> completed;
+    bool stopping = false;
+
+    void workerLoop();
+    sf::Vector2u getLevelSize(int level) const;
+    sf::FloatRect getImageRect(const TileKey& key) const;
+    static std::size_t getTextureBytes(const TextureTile& tile);
+};
+
+#endif // MAP_TEXTURE_TILES_HPP
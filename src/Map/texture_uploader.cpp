@@ -0,0 +1,103 @@
+#include "texture_uploader.hpp"
+#include "../Utils/thread_pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+TextureUploader::TextureUploader(sf::Time frameBudget, std::size_t chunkBytes, bool useRawCache)
+    : frameBudget(frameBudget), chunkBytes(chunkBytes), useRawCache(useRawCache) {}
+
+std::unique_ptr<TextureUploader::DecodedImage> TextureUploader::decode(const std::string& path, bool useRawCache) {
+    auto decoded = std::make_unique<DecodedImage>();
+
+    if (useRawCache && decoded->cache.open(path)) {
+        decoded->pixels = decoded->cache.getPixels();
+        decoded->size = decoded->cache.getSize();
+
+        // Fault the pages in here rather than in the middle of a main thread upload
+        const std::size_t bytes = static_cast<std::size_t>(decoded->size.x) * decoded->size.y * 4;
+        volatile sf::Uint8 sink = 0;
+        for (std::size_t i = 0; i < bytes; i += 4096) {
+            sink = sink + decoded->pixels[i];
+        }
+        return decoded;
+    }
+
+    auto image = std::make_shared<sf::Image>();
+    if (!image->loadFromFile(path)) {
+        return nullptr;
+    }
+    if (useRawCache) {
+        // A separate background task, the first run shows the image without waiting for a full size
+        // write and a second read of the source
+        ThreadPool::global().submit([path, image]() {
+            RawImageCache::write(path, *image);
+        });
+    }
+    decoded->pixels = image->getPixelsPtr();
+    decoded->size = image->getSize();
+    decoded->image = std::move(image);
+    return decoded;
+}
+
+void TextureUploader::enqueue(const std::string& path, sf::Texture& target, std::function<void(bool)> onReady) {
+    Job job;
+    job.path = path;
+    job.target = &target;
+    job.onReady = std::move(onReady);
+    job.decode = ThreadPool::global().async([path, useRawCache = useRawCache]() { return decode(path, useRawCache); });
+    jobs.push_back(std::move(job));
+}
+
+void TextureUploader::update() {
+    sf::Clock clock;
+    bool uploaded = false;
+
+    auto it = jobs.begin();
+    while (it != jobs.end()) {
+        Job& job = *it;
+        bool failed = false;
+
+        if (!job.image) {
+            if (job.decode.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                ++it;
+                continue;
+            }
+            job.image = job.decode.get();
+            const sf::Vector2u size = job.image ? job.image->size : sf::Vector2u();
+            failed = !job.image || !job.target->create(size.x, size.y);
+        }
+
+        if (!failed) {
+            if (uploaded && clock.getElapsedTime() >= frameBudget) {
+                return;
+            }
+
+            const sf::Vector2u size = job.image->size;
+            const std::size_t rowBytes = static_cast<std::size_t>(size.x) * 4;
+            const unsigned rows = std::min(size.y - job.nextRow, static_cast<unsigned>(std::max<std::size_t>(1, chunkBytes / rowBytes)));
+            job.target->update(job.image->pixels + job.nextRow * rowBytes, size.x, rows, 0, job.nextRow);
+            job.nextRow += rows;
+            uploaded = true;
+
+            if (job.nextRow < size.y) {
+                continue;
+            }
+        } else {
+            std::cerr << "Failed to load texture: " << job.path << std::endl;
+        }
+
+        if (job.onReady) {
+            job.onReady(!failed);
+        }
+        it = jobs.erase(it);
+    }
+}
+
+bool TextureUploader::isIdle() const {
+    return jobs.empty();
+}
+
+std::size_t TextureUploader::getPendingCount() const {
+    return jobs.size();
+}
@@ -0,0 +1,56 @@
+#ifndef MAP_TEXTURE_UPLOADER_HPP
+#define MAP_TEXTURE_UPLOADER_HPP
+
+#include <SFML/Graphics.hpp>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <string>
+#include "raw_image_cache.hpp"
+
+// Decodes images on the shared thread pool and uploads them on the main thread a band of rows at a time,
+// so a large texture is spread over several frames instead of stalling one.
+// sf::Texture must only be touched from the thread that owns the GL context.
+// With the raw cache enabled a PNG is decoded once, later runs map its RawImageCache instead.
+// The cache is written by a background task after the decoded image has been handed over.
+class TextureUploader {
+public:
+    explicit TextureUploader(sf::Time frameBudget = sf::milliseconds(4), std::size_t chunkBytes = 4 * 1024 * 1024, bool useRawCache = true);
+
+    // target must outlive the upload, onReady runs on the main thread once the last row is in
+    void enqueue(const std::string& path, sf::Texture& target, std::function<void(bool)> onReady = {});
+
+    // Main thread, once per frame: uploads until the budget is spent, always at least one chunk
+    void update();
+
+    bool isIdle() const;
+    std::size_t getPendingCount() const;
+
+private:
+    // Pixels of either a decoded image or a mapped cache
+    struct DecodedImage {
+        std::shared_ptr<const sf::Image> image;   // shared with the cache write
+        RawImageCache cache;
+        const sf::Uint8* pixels = nullptr;
+        sf::Vector2u size;
+    };
+
+    struct Job {
+        std::string path;
+        sf::Texture* target = nullptr;
+        std::function<void(bool)> onReady;
+        std::future<std::unique_ptr<DecodedImage>> decode;
+        std::unique_ptr<DecodedImage> image;
+        unsigned nextRow = 0;
+    };
+
+    sf::Time frameBudget;
+    std::size_t chunkBytes;
+    bool useRawCache;
+    std::list<Job> jobs;   // uploaded in submission order once decoded
+
+    static std::unique_ptr<DecodedImage> decode(const std::string& path, bool useRawCache);
+};
+
+#endif // MAP_TEXTURE_UPLOADER_HPP
@@ -0,0 +1,27 @@
+#ifndef MAP_TILE_KEY_HPP
+#define MAP_TILE_KEY_HPP
+
+#include <functional>
+
+// Address of a tile in a z/x/y pyramid, z = 0 is the coarsest level
+struct TileKey {
+    int z;
+    int x;
+    int y;
+
+    bool operator==(const TileKey& other) const {
+        return z == other.z && x == other.x && y == other.y;
+    }
+
+    TileKey getParent() const {
+        return TileKey{z - 1, x / 2, y / 2};
+    }
+};
+
+struct TileKeyHash {
+    std::size_t operator()(const TileKey& key) const {
+        return std::hash<long long>()((static_cast<long long>(key.z) << 48) ^ (static_cast<long long>(key.x) << 24) ^ key.y);
+    }
+};
+
+#endif // MAP_TILE_KEY_HPP
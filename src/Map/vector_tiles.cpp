@@ -0,0 +1,236 @@
+#include "vector_tiles.hpp"
+#include "../Utils/frame_arena.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+VectorTileCache::VectorTileCache(std::size_t capacity) : capacity(capacity) {}
+
+VectorTileCache::~VectorTileCache() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+bool VectorTileCache::open(const std::string& directory, double quantum) {
+    std::ifstream file(directory + "/meta.json");
+    if (!file.is_open()) {
+        return false;
+    }
+
+    nlohmann::json meta = nlohmann::json::parse(file, nullptr, false);
+    if (meta.is_discarded() || !meta.contains("bounds") || !meta.contains("maxZoom")) {
+        std::cerr << "Invalid vector tile metadata in " << directory << std::endl;
+        return false;
+    }
+
+    this->directory = directory;
+    this->quantum = quantum;
+    minX = meta["bounds"][0].get<double>();
+    minY = meta["bounds"][1].get<double>();
+    maxX = meta["bounds"][2].get<double>();
+    maxY = meta["bounds"][3].get<double>();
+    maxZoom = meta["maxZoom"].get<int>();
+
+    if (!worker.joinable()) {
+        worker = std::thread(&VectorTileCache::workerLoop, this);
+    }
+    return true;
+}
+
+bool VectorTileCache::isOpen() const {
+    return maxZoom >= 0;
+}
+
+int VectorTileCache::getMaxZoom() const {
+    return maxZoom;
+}
+
+int VectorTileCache::selectZoom(double mapUnitsPerPixel, double tilePixels) const {
+    const double tilesAcross = (maxX - minX) / (mapUnitsPerPixel * tilePixels);
+    const int zoom = static_cast<int>(std::round(std::log2(std::max(tilesAcross, 1.0))));
+    return std::clamp(zoom, 0, maxZoom);
+}
+
+void VectorTileCache::update() {
+    std::vector<std::pair<TileKey, std::unique_ptr<VectorTile>>> finished;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished.swap(completed);
+    }
+
+    for (auto& [key, tile] : finished) {
+        pending.erase(key);
+        if (!tile) {
+            empty.insert(key);
+            continue;
+        }
+        lru.push_front(std::move(*tile));
+        resident[key] = lru.begin();
+    }
+
+    while (resident.size() > capacity) {
+        resident.erase(lru.back().key);
+        lru.pop_back();
+    }
+}
+
+void VectorTileCache::request(const sf::Rect<double>& mapRect, int zoom, std::vector<const VectorTile*>& drawable) {
+    drawable.clear();
+    if (!isOpen()) {
+        return;
+    }
+
+    const int tiles = 1 << zoom;
+    const double tileWidth = (maxX - minX) / tiles;
+    const double tileHeight = (maxY - minY) / tiles;
+    const int firstX = std::clamp(static_cast<int>(std::floor((mapRect.left - minX) / tileWidth)), 0, tiles - 1);
+    const int lastX = std::clamp(static_cast<int>(std::floor((mapRect.left + mapRect.width - minX) / tileWidth)), 0, tiles - 1);
+    const int firstY = std::clamp(static_cast<int>(std::floor((mapRect.top - minY) / tileHeight)), 0, tiles - 1);
+    const int lastY = std::clamp(static_cast<int>(std::floor((mapRect.top + mapRect.height - minY) / tileHeight)), 0, tiles - 1);
+
+    FrameVector<TileKey> wanted;
+    wanted.reserve(static_cast<std::size_t>(lastX - firstX + 1) * (lastY - firstY + 1));
+    for (int x = firstX; x <= lastX; x++) {
+        for (int y = firstY; y <= lastY; y++) {
+            const TileKey key{zoom, x, y};
+            if (empty.count(key)) {
+                continue;
+            }
+
+            auto it = resident.find(key);
+            if (it != resident.end()) {
+                lru.splice(lru.begin(), lru, it->second);
+                drawable.push_back(&*it->second);
+                continue;
+            }
+
+            wanted.push_back(key);
+
+            // Show the closest resident ancestor while this one loads
+            for (TileKey parent = key; parent.z > 0;) {
+                parent = parent.getParent();
+                auto parentIt = resident.find(parent);
+                if (parentIt != resident.end()) {
+                    const VectorTile* tile = &*parentIt->second;
+                    if (std::find(drawable.begin(), drawable.end(), tile) == drawable.end()) {
+                        drawable.push_back(tile);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    // Only the tiles wanted this frame stay queued, stale requests from earlier views are dropped
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const TileKey& key : queue) {
+            pending.erase(key);
+        }
+        queue.clear();
+        for (const TileKey& key : wanted) {
+            if (pending.insert(key).second) {
+                queue.push_back(key);
+            }
+        }
+    }
+    if (!wanted.empty()) {
+        condition.notify_one();
+    }
+}
+
+std::size_t VectorTileCache::getResidentCount() const {
+    return resident.size();
+}
+
+std::size_t VectorTileCache::getPendingCount() const {
+    return pending.size();
+}
+
+std::size_t VectorTileCache::getPointCount() const {
+    std::size_t points = 0;
+    for (const VectorTile& tile : lru) {
+        points += tile.lines.getTotalPointCount();
+    }
+    return points;
+}
+
+std::size_t VectorTileCache::getMemoryUsage() const {
+    std::size_t bytes = 0;
+    for (const VectorTile& tile : lru) {
+        bytes += tile.lines.getMemoryUsage() + tile.lineBounds.capacity() * sizeof(sf::Rect<double>);
+    }
+    return bytes;
+}
+
+void VectorTileCache::workerLoop() {
+    while (true) {
+        TileKey key;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this]() { return stopping || !queue.empty(); });
+            if (stopping) {
+                return;
+            }
+            key = queue.front();
+            queue.pop_front();
+        }
+
+        std::unique_ptr<VectorTile> tile = loadTile(key);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        completed.emplace_back(key, std::move(tile));
+    }
+}
+
+std::unique_ptr<VectorTile> VectorTileCache::loadTile(const TileKey& key) const {
+    const std::string path = directory + "/" + std::to_string(key.z) + "/" + std::to_string(key.x) + "/" + std::to_string(key.y) + ".json";
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return nullptr;
+    }
+
+    nlohmann::json data = nlohmann::json::parse(file, nullptr, false);
+    if (data.is_discarded() || !data.contains("lines")) {
+        std::cerr << "Invalid vector tile: " << path << std::endl;
+        return nullptr;
+    }
+
+    auto tile = std::make_unique<VectorTile>();
+    tile->key = key;
+    tile->lines = GeometryStore(quantum);
+
+    std::vector<double> coordinates;
+    bool first = true;
+    for (const auto& line : data["lines"]) {
+        coordinates = line.get<std::vector<double>>();
+        if (coordinates.size() < 4) {
+            continue;
+        }
+        if (first) {
+            tile->lines.beginFeature(coordinates[0], coordinates[1]);
+            first = false;
+        }
+        tile->lines.addRing(coordinates.data(), coordinates.size() / 2);
+
+        double left = coordinates[0], top = coordinates[1], right = left, bottom = top;
+        for (std::size_t i = 2; i + 1 < coordinates.size(); i += 2) {
+            left = std::min(left, coordinates[i]);
+            right = std::max(right, coordinates[i]);
+            top = std::min(top, coordinates[i + 1]);
+            bottom = std::max(bottom, coordinates[i + 1]);
+        }
+        tile->lineBounds.emplace_back(left, top, right - left, bottom - top);
+    }
+    tile->lines.shrinkToFit();
+    tile->lineBounds.shrink_to_fit();
+    return tile;
+}
@@ -0,0 +1,78 @@
+#ifndef MAP_VECTOR_TILES_HPP
+#define MAP_VECTOR_TILES_HPP
+
+#include <SFML/Graphics.hpp>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "geometry_store.hpp"
+#include "tile_key.hpp"
+
+struct VectorTile {
+    TileKey key;
+    GeometryStore lines;   // border lines clipped to the tile, absolute map coordinates
+    std::vector<sf::Rect<double>> lineBounds;   // bounds of each line, for view culling
+};
+
+// Streams the z/x/y border tiles written by scripts/geo/tile.py.
+// Tiles are parsed on a background thread, kept in a bounded LRU cache, and a missing
+// tile is stood in for by its nearest resident ancestor so the caller never waits.
+class VectorTileCache {
+public:
+    explicit VectorTileCache(std::size_t capacity = 256);
+    ~VectorTileCache();
+
+    // Reads meta.json from the directory and starts the loader thread
+    bool open(const std::string& directory, double quantum);
+    bool isOpen() const;
+    int getMaxZoom() const;
+
+    // Zoom whose tiles are about tilePixels wide on screen
+    int selectZoom(double mapUnitsPerPixel, double tilePixels = 512.0) const;
+
+    // Main thread, once per frame: adopt finished loads and evict least recently used tiles
+    void update();
+
+    // Queue the tiles covering mapRect (absolute map coordinates) and collect what can be drawn now
+    void request(const sf::Rect<double>& mapRect, int zoom, std::vector<const VectorTile*>& drawable);
+
+    std::size_t getResidentCount() const;
+    std::size_t getPendingCount() const;
+    // Points in the resident tiles
+    std::size_t getPointCount() const;
+    // Bytes held by the resident tiles
+    std::size_t getMemoryUsage() const;
+
+private:
+    std::string directory;
+    double quantum = 1e-6;
+    double minX = 0.0, minY = 0.0, maxX = 0.0, maxY = 0.0;
+    int maxZoom = -1;
+    std::size_t capacity;
+
+    // Main thread state, the most recently used tile is at the front
+    std::list<VectorTile> lru;
+    std::unordered_map<TileKey, std::list<VectorTile>::iterator, TileKeyHash> resident;
+    std::unordered_set<TileKey, TileKeyHash> pending;
+    std::unordered_set<TileKey, TileKeyHash> empty;   // tiles the pyramid does not contain
+
+    // Shared with the loader thread
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<TileKey> queue;
+    std::vector<std::pair<TileKey, std::unique_ptr<VectorTile>>> completed;
+    bool stopping = false;
+
+    void workerLoop();
+    std::unique_ptr<VectorTile> loadTile(const TileKey& key) const;
+};
+
+#endif // MAP_VECTOR_TILES_HPP
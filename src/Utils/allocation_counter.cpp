@@ -0,0 +1,79 @@
+// allocation_counter.cpp
+#include "allocation_counter.hpp"
+#include <cstdlib>
+#include <new>
+
+namespace {
+    thread_local std::uint64_t threadAllocations = 0;
+
+    void* countedAllocate(std::size_t size) {
+        ++threadAllocations;
+        void* memory = std::malloc(size > 0 ? size : 1);
+        if (!memory) {
+            throw std::bad_alloc();
+        }
+        return memory;
+    }
+}
+
+void* operator new(std::size_t size) {
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return countedAllocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return countedAllocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return countedAllocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept {
+    std::free(memory);
+}
+
+AllocationCounter::AllocationCounter() : start(threadAllocations) {}
+
+void AllocationCounter::reset() {
+    start = threadAllocations;
+}
+
+std::uint64_t AllocationCounter::getCount() const {
+    return threadAllocations - start;
+}
+
+std::uint64_t AllocationCounter::getThreadTotal() {
+    return threadAllocations;
+}
@@ -0,0 +1,26 @@
+// allocation_counter.hpp
+#ifndef ALLOCATION_COUNTER_HPP
+#define ALLOCATION_COUNTER_HPP
+
+#include <cstdint>
+
+// Counts the calling thread's calls to the global operator new, to check that a section of code
+// stays off the heap. Linking this in replaces the global operator new and delete for the whole
+// program, the counting itself is a thread local increment. Over-aligned allocations are not counted.
+class AllocationCounter {
+public:
+    // Counts from construction
+    AllocationCounter();
+
+    void reset();
+    // Allocations made by this thread since construction or the last reset
+    std::uint64_t getCount() const;
+
+    // Allocations made by this thread since it started
+    static std::uint64_t getThreadTotal();
+
+private:
+    std::uint64_t start;
+};
+
+#endif // ALLOCATION_COUNTER_HPP
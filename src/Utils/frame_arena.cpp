@@ -0,0 +1,61 @@
+// frame_arena.cpp
+#include "frame_arena.hpp"
+#include <algorithm>
+#include <cstdint>
+
+FrameArena::FrameArena(std::size_t capacity)
+    : block(std::make_unique<std::byte[]>(capacity)), capacity(capacity), current(block.get()), currentSize(capacity) {}
+
+FrameArena& FrameArena::get() {
+    static FrameArena arena;
+    return arena;
+}
+
+void* FrameArena::allocate(std::size_t bytes, std::size_t alignment) {
+    std::uintptr_t address = reinterpret_cast<std::uintptr_t>(current) + offset;
+    std::size_t padding = (alignment - address % alignment) % alignment;
+
+    if (offset + padding + bytes > currentSize) {
+        // Spill into a new chunk, at least as big as the block so a run of small allocations doesn't add one each
+        const std::size_t chunkSize = std::max(bytes + alignment, capacity);
+        overflow.push_back(std::make_unique<std::byte[]>(chunkSize));
+        overflowCapacity += chunkSize;
+        current = overflow.back().get();
+        currentSize = chunkSize;
+        offset = 0;
+        address = reinterpret_cast<std::uintptr_t>(current);
+        padding = (alignment - address % alignment) % alignment;
+    }
+
+    void* result = current + offset + padding;
+    offset += padding + bytes;
+    used += bytes;
+    return result;
+}
+
+void FrameArena::reset() {
+    peak = std::max(peak, used);
+    if (!overflow.empty()) {
+        // Everything this frame needed in one block from now on
+        capacity += overflowCapacity;
+        overflow.clear();
+        overflowCapacity = 0;
+        block = std::make_unique<std::byte[]>(capacity);
+    }
+    current = block.get();
+    currentSize = capacity;
+    offset = 0;
+    used = 0;
+}
+
+std::size_t FrameArena::getUsed() const {
+    return used;
+}
+
+std::size_t FrameArena::getCapacity() const {
+    return capacity + overflowCapacity;
+}
+
+std::size_t FrameArena::getPeak() const {
+    return std::max(peak, used);
+}
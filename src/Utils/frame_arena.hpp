@@ -0,0 +1,82 @@
+// frame_arena.hpp
+#ifndef FRAME_ARENA_HPP
+#define FRAME_ARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Bump allocator for data that only lives until the end of the frame. Nothing is freed on its
+// own, reset() after display() releases the whole frame at once. A frame that outgrows the block
+// spills into extra chunks, the next reset folds them into one larger block so the following
+// frames fit without touching the heap again.
+class FrameArena {
+public:
+    explicit FrameArena(std::size_t capacity = 1024 * 1024);
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // The render thread's arena, reset once per frame by the loop that owns the window
+    static FrameArena& get();
+
+    void* allocate(std::size_t bytes, std::size_t alignment);
+    void reset();
+
+    // Bytes handed out since the last reset
+    std::size_t getUsed() const;
+    std::size_t getCapacity() const;
+    // Most bytes any frame has used
+    std::size_t getPeak() const;
+
+private:
+    std::unique_ptr<std::byte[]> block;
+    std::size_t capacity;
+    std::vector<std::unique_ptr<std::byte[]>> overflow;   // chunks added by the current frame
+    std::size_t overflowCapacity = 0;
+
+    // The chunk being bumped, either the block or the newest overflow chunk
+    std::byte* current;
+    std::size_t currentSize;
+    std::size_t offset = 0;
+
+    std::size_t used = 0;
+    std::size_t peak = 0;
+};
+
+// Standard allocator over a FrameArena, deallocation is a no-op. Containers using it must not
+// outlive the frame, and should reserve up front since every reallocation leaves the old buffer behind.
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    ArenaAllocator() noexcept : arena(&FrameArena::get()) {}
+    explicit ArenaAllocator(FrameArena& arena) noexcept : arena(&arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.arena) {}
+
+    T* allocate(std::size_t count) {
+        return static_cast<T*>(arena->allocate(count * sizeof(T), alignof(T)));
+    }
+    void deallocate(T*, std::size_t) noexcept {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept {
+        return arena == other.arena;
+    }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const noexcept {
+        return arena != other.arena;
+    }
+
+private:
+    template <typename U>
+    friend class ArenaAllocator;
+
+    FrameArena* arena;
+};
+
+template <typename T>
+using FrameVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif // FRAME_ARENA_HPP
@@ -0,0 +1,50 @@
+// frame_stats.cpp
+#include "frame_stats.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <numeric>
+
+FrameStats::FrameStats(const std::string& name) : name(name) {}
+
+void FrameStats::addSample(sf::Time time) {
+    samplesMs.push_back(time.asMicroseconds() / 1000.0);
+}
+
+void FrameStats::clear() {
+    samplesMs.clear();
+}
+
+std::size_t FrameStats::getSampleCount() const {
+    return samplesMs.size();
+}
+
+double FrameStats::getMeanMs() const {
+    if (samplesMs.empty()) {
+        return 0.0;
+    }
+    return std::accumulate(samplesMs.begin(), samplesMs.end(), 0.0) / samplesMs.size();
+}
+
+double FrameStats::getPercentileMs(double p) const {
+    if (samplesMs.empty()) {
+        return 0.0;
+    }
+    std::vector<double> sorted = samplesMs;
+    std::sort(sorted.begin(), sorted.end());
+    const double rank = std::ceil(std::clamp(p, 0.0, 100.0) / 100.0 * sorted.size());
+    const std::size_t index = static_cast<std::size_t>(std::max(rank, 1.0)) - 1;
+    return sorted[index];
+}
+
+void FrameStats::print(std::ostream& out) const {
+    out << std::fixed << std::setprecision(3)
+        << std::left << std::setw(24) << name << std::right
+        << " frames " << std::setw(6) << samplesMs.size()
+        << "  mean " << std::setw(8) << getMeanMs() << " ms"
+        << "  p50 " << std::setw(8) << getPercentileMs(50) << " ms"
+        << "  p95 " << std::setw(8) << getPercentileMs(95) << " ms"
+        << "  p99 " << std::setw(8) << getPercentileMs(99) << " ms"
+        << "  max " << std::setw(8) << getPercentileMs(100) << " ms"
+        << std::endl;
+}
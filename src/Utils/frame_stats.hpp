@@ -0,0 +1,31 @@
+// frame_stats.hpp
+#ifndef FRAME_STATS_HPP
+#define FRAME_STATS_HPP
+
+#include <SFML/System.hpp>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Collects per-frame timings and reports percentiles
+class FrameStats {
+public:
+    explicit FrameStats(const std::string& name);
+
+    void addSample(sf::Time time);
+    void clear();
+
+    std::size_t getSampleCount() const;
+    double getMeanMs() const;
+    // p in [0, 100], nearest-rank percentile in milliseconds
+    double getPercentileMs(double p) const;
+
+    // One line summary: name, count, mean, p50, p95, p99, max
+    void print(std::ostream& out) const;
+
+private:
+    std::string name;
+    std::vector<double> samplesMs;
+};
+
+#endif // FRAME_STATS_HPP
@@ -0,0 +1,206 @@
+// job_graph.cpp
+#include "job_graph.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+JobGraph::~JobGraph() {
+    std::unique_lock<std::mutex> lock(mutex);
+    stopping = true;
+    while (submittedTasks > 0) {
+        // Queued jobs see stopping and return at once, help them through if the pool is busy
+        lock.unlock();
+        const bool ran = ThreadPool::global().runPendingTask();
+        lock.lock();
+        if (!ran) {
+            condition.wait_for(lock, std::chrono::milliseconds(1), [this]() { return submittedTasks == 0; });
+        }
+    }
+}
+
+JobGraph::JobId JobGraph::add(const std::string& name, unsigned weight, Work work, const std::vector<JobId>& dependencies) {
+    return addJob(name, weight, std::move(work), Step(), dependencies);
+}
+
+JobGraph::JobId JobGraph::addMainThread(const std::string& name, unsigned weight, Step step, const std::vector<JobId>& dependencies) {
+    return addJob(name, weight, Work(), std::move(step), dependencies);
+}
+
+JobGraph::JobId JobGraph::addJob(const std::string& name, unsigned weight, Work work, Step step, const std::vector<JobId>& dependencies) {
+    std::lock_guard<std::mutex> lock(mutex);
+    const JobId id = jobs.size();
+
+    auto job = std::make_unique<Job>();
+    job->name = name;
+    job->weight = weight;
+    job->work = std::move(work);
+    job->step = std::move(step);
+    bool dependencyFailed = false;
+    for (JobId dependency : dependencies) {
+        if (jobs[dependency]->failed) {
+            dependencyFailed = true;
+        } else if (!jobs[dependency]->done) {
+            jobs[dependency]->dependents.push_back(id);
+            ++job->remainingDependencies;
+        }
+    }
+    jobs.push_back(std::move(job));
+    totalWeight += weight;
+
+    if (dependencyFailed) {
+        skip(id);
+    } else if (jobs[id]->remainingDependencies == 0) {
+        makeReady(id);
+    }
+    return id;
+}
+
+void JobGraph::makeReady(JobId job) {
+    if (jobs[job]->step) {
+        readySteps.push_back(job);
+    } else if (started) {
+        submit(job);
+    } else {
+        readyWork.push_back(job);
+    }
+}
+
+void JobGraph::submit(JobId job) {
+    ++submittedTasks;
+    ThreadPool::global().submit([this, job]() { run(job); }, TaskPriority::Background);
+}
+
+void JobGraph::finish(JobId job, bool succeeded) {
+    Job& finished = *jobs[job];
+    finished.running = false;
+    finished.failed = !succeeded;
+    finished.done = succeeded;
+    completedWeight += finished.weight;
+    ++completedJobs;
+
+    for (JobId dependent : finished.dependents) {
+        if (!succeeded) {
+            skip(dependent);
+        } else if (!jobs[dependent]->failed && --jobs[dependent]->remainingDependencies == 0) {
+            makeReady(dependent);
+        }
+    }
+    condition.notify_all();
+}
+
+void JobGraph::skip(JobId job) {
+    // Reached once per failed dependency, only the first one counts
+    if (jobs[job]->failed) {
+        return;
+    }
+    std::cerr << "Skipping " << jobs[job]->name << ", a job it depends on failed" << std::endl;
+    finish(job, false);
+}
+
+void JobGraph::start() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (started) {
+        return;
+    }
+    started = true;
+
+    for (JobId job : readyWork) {
+        submit(job);
+    }
+    readyWork.clear();
+}
+
+void JobGraph::run(JobId id) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!stopping) {
+        Job& job = *jobs[id];
+        job.running = true;
+
+        lock.unlock();
+        std::exception_ptr error;
+        bool succeeded = false;
+        try {
+            succeeded = job.work();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        lock.lock();
+
+        if (error && !failure) {
+            failure = error;
+        }
+        finish(id, succeeded);
+    }
+    --submittedTasks;
+    condition.notify_all();
+}
+
+void JobGraph::poll() {
+    std::vector<JobId> steps;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (failure) {
+            std::exception_ptr error = failure;
+            failure = nullptr;
+            std::rethrow_exception(error);
+        }
+        steps = readySteps;
+        for (JobId id : steps) {
+            jobs[id]->running = true;
+        }
+    }
+
+    // Steps run without the lock, they may take a frame's worth of time
+    for (JobId id : steps) {
+        if (jobs[id]->step()) {
+            std::lock_guard<std::mutex> lock(mutex);
+            readySteps.erase(std::find(readySteps.begin(), readySteps.end(), id));
+            finish(id, true);
+        }
+    }
+}
+
+void JobGraph::wait() {
+    start();
+    while (!isComplete()) {
+        poll();
+        // Lend this thread to the pool rather than sleep through the load
+        if (!ThreadPool::global().runPendingTask()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    poll();
+}
+
+bool JobGraph::isDone(JobId job) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return jobs[job]->done;
+}
+
+bool JobGraph::isFailed(JobId job) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return jobs[job]->failed;
+}
+
+bool JobGraph::isComplete() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return completedJobs == jobs.size();
+}
+
+float JobGraph::getProgress() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return totalWeight == 0 ? 1.0f : static_cast<float>(completedWeight) / totalWeight;
+}
+
+std::string JobGraph::getStatus() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::string status;
+    for (const auto& job : jobs) {
+        if (job->running) {
+            status += status.empty() ? job->name : ", " + job->name;
+        }
+    }
+    return status;
+}
@@ -0,0 +1,89 @@
+// job_graph.hpp
+#ifndef JOB_GRAPH_HPP
+#define JOB_GRAPH_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Loading work with declared dependencies. Worker jobs go to the shared thread pool as background
+// tasks as soon as everything they depend on is done; main thread jobs (anything touching the window's GL state)
+// are stepped from poll() once per frame until they report completion, so the frame loop keeps running.
+// A job that fails, by returning false or throwing, never runs its dependents, they are skipped as failed too.
+class JobGraph {
+public:
+    using JobId = std::size_t;
+    using Work = std::function<bool()>;   // returns false when the job failed
+    using Step = std::function<bool()>;   // returns true when the job is finished
+
+    JobGraph() = default;
+    JobGraph(const JobGraph&) = delete;
+    JobGraph& operator=(const JobGraph&) = delete;
+    // Waits for running worker jobs, jobs not started yet are dropped
+    ~JobGraph();
+
+    // weight is the job's share of the progress, dependencies must have been added before
+    JobId add(const std::string& name, unsigned weight, Work work, const std::vector<JobId>& dependencies = {});
+    JobId addMainThread(const std::string& name, unsigned weight, Step step, const std::vector<JobId>& dependencies = {});
+
+    // Hands the ready worker jobs to the pool, later ones follow as their dependencies finish
+    void start();
+
+    // Main thread, once per frame: steps ready main thread jobs and rethrows the first job failure
+    void poll();
+    // Polls until every job is done, for tools and benchmarks that have no frame loop
+    void wait();
+
+    // Finished successfully, a failed or skipped job is never done
+    bool isDone(JobId job) const;
+    bool isFailed(JobId job) const;
+    // Every job finished, failed or skipped
+    bool isComplete() const;
+    // Finished weight over total weight, safe from any thread
+    float getProgress() const;
+    // Names of the jobs running right now
+    std::string getStatus() const;
+
+private:
+    struct Job {
+        std::string name;
+        unsigned weight = 1;
+        Work work;
+        Step step;
+        std::vector<JobId> dependents;
+        std::size_t remainingDependencies = 0;
+        bool running = false;
+        bool failed = false;
+        std::atomic<bool> done{false};
+    };
+
+    std::vector<std::unique_ptr<Job>> jobs;
+    mutable std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<JobId> readyWork;     // worker jobs waiting for start()
+    std::vector<JobId> readySteps;   // main thread jobs whose dependencies are done
+    std::exception_ptr failure;
+    bool started = false;
+    bool stopping = false;
+    std::size_t submittedTasks = 0;  // pool tasks that have not returned yet
+
+    unsigned totalWeight = 0;
+    std::atomic<unsigned> completedWeight{0};
+    std::atomic<std::size_t> completedJobs{0};
+
+    JobId addJob(const std::string& name, unsigned weight, Work work, Step step, const std::vector<JobId>& dependencies);
+    void makeReady(JobId job);
+    // Caller holds the mutex
+    void finish(JobId job, bool succeeded);
+    void skip(JobId job);
+    void submit(JobId job);
+    void run(JobId job);
+};
+
+#endif // JOB_GRAPH_HPP
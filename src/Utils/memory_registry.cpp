@@ -0,0 +1,120 @@
+// memory_registry.cpp
+#include "memory_registry.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+MemoryUsage& MemoryUsage::operator+=(const MemoryUsage& other) {
+    bytes += other.bytes;
+    allocations += other.allocations;
+    return *this;
+}
+
+bool MemoryRegistry::isInGroup(const std::string& entry, const std::string& group) {
+    return entry == group
+        || (entry.size() > group.size() && entry.compare(0, group.size(), group) == 0 && entry[group.size()] == '.');
+}
+
+void MemoryRegistry::report(const std::string& name, const MemoryUsage& usage) {
+    auto it = std::find_if(entries.begin(), entries.end(), [&name](const Entry& entry) { return entry.name == name; });
+    if (it != entries.end()) {
+        it->usage = usage;
+    } else {
+        entries.push_back({name, usage});
+    }
+}
+
+void MemoryRegistry::setBudget(const std::string& name, std::size_t bytes) {
+    auto it = std::find_if(budgets.begin(), budgets.end(), [&name](const Budget& budget) { return budget.name == name; });
+    if (it != budgets.end()) {
+        it->bytes = bytes;
+    } else {
+        budgets.push_back({name, bytes});
+    }
+}
+
+bool MemoryRegistry::loadBudgets(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    nlohmann::json config = nlohmann::json::parse(file, nullptr, false);
+    if (config.is_discarded() || !config.is_object()) {
+        std::cerr << "Invalid memory budgets in " << path << std::endl;
+        return false;
+    }
+    for (const auto& [name, megabytes] : config.items()) {
+        if (megabytes.is_number()) {
+            setBudget(name, static_cast<std::size_t>(megabytes.get<double>() * 1024 * 1024));
+        }
+    }
+    return true;
+}
+
+void MemoryRegistry::checkBudgets() {
+    for (Budget& budget : budgets) {
+        const std::size_t bytes = getUsage(budget.name).bytes;
+        if (bytes > budget.bytes && !budget.exceeded) {
+            std::cerr << "Memory budget exceeded: " << budget.name << " uses " << bytes / (1024.0 * 1024.0)
+                      << " MB of " << budget.bytes / (1024.0 * 1024.0) << " MB" << std::endl;
+        }
+        budget.exceeded = bytes > budget.bytes;
+    }
+}
+
+const std::vector<MemoryRegistry::Entry>& MemoryRegistry::getEntries() const {
+    return entries;
+}
+
+MemoryUsage MemoryRegistry::getUsage(const std::string& name) const {
+    MemoryUsage usage;
+    for (const Entry& entry : entries) {
+        if (isInGroup(entry.name, name)) {
+            usage += entry.usage;
+        }
+    }
+    return usage;
+}
+
+MemoryUsage MemoryRegistry::getTotal() const {
+    MemoryUsage usage;
+    for (const Entry& entry : entries) {
+        usage += entry.usage;
+    }
+    return usage;
+}
+
+std::size_t MemoryRegistry::getBudget(const std::string& name) const {
+    auto it = std::find_if(budgets.begin(), budgets.end(), [&name](const Budget& budget) { return budget.name == name; });
+    return it != budgets.end() ? it->bytes : 0;
+}
+
+bool MemoryRegistry::save(const std::string& path) const {
+    nlohmann::json output;
+    const MemoryUsage total = getTotal();
+    output["total"] = {{"bytes", total.bytes}, {"allocations", total.allocations}};
+
+    output["entries"] = nlohmann::json::array();
+    for (const Entry& entry : entries) {
+        nlohmann::json item = {{"name", entry.name}, {"bytes", entry.usage.bytes}, {"allocations", entry.usage.allocations}};
+        if (const std::size_t budget = getBudget(entry.name)) {
+            item["budget"] = budget;
+        }
+        output["entries"].push_back(item);
+    }
+
+    output["budgets"] = nlohmann::json::array();
+    for (const Budget& budget : budgets) {
+        output["budgets"].push_back({{"name", budget.name}, {"bytes", budget.bytes}, {"used", getUsage(budget.name).bytes}});
+    }
+
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Failed to write memory report: " << path << std::endl;
+        return false;
+    }
+    file << output.dump(4);
+    return static_cast<bool>(file);
+}
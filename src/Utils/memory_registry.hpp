@@ -0,0 +1,72 @@
+// memory_registry.hpp
+#ifndef MEMORY_REGISTRY_HPP
+#define MEMORY_REGISTRY_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+struct MemoryUsage {
+    std::size_t bytes = 0;
+    std::size_t allocations = 0;   // heap blocks behind the bytes
+
+    MemoryUsage& operator+=(const MemoryUsage& other);
+};
+
+// What a vector holds on the heap, by capacity
+template <typename T>
+MemoryUsage measureMemory(const std::vector<T>& values) {
+    return {values.capacity() * sizeof(T), values.capacity() > 0 ? 1u : 0u};
+}
+
+template <typename T>
+MemoryUsage measureMemory(const std::vector<std::vector<T>>& rows) {
+    MemoryUsage usage{rows.capacity() * sizeof(std::vector<T>), rows.capacity() > 0 ? 1u : 0u};
+    for (const auto& row : rows) {
+        usage += measureMemory(row);
+    }
+    return usage;
+}
+
+// Where the memory goes, by subsystem. Subsystems report their current usage under dotted names
+// ("terrain.heightfield"), and budgets can be set for a whole group ("terrain") or a single entry.
+// Crossing a budget logs one warning, another is logged only after usage has dropped back under it.
+class MemoryRegistry {
+public:
+    struct Entry {
+        std::string name;
+        MemoryUsage usage;
+    };
+
+    // Replaces what was last reported under this name
+    void report(const std::string& name, const MemoryUsage& usage);
+    void setBudget(const std::string& name, std::size_t bytes);
+    // A JSON object of group or entry names to budgets in megabytes, missing file is not an error
+    bool loadBudgets(const std::string& path);
+    // Warns about budgets crossed since the last check
+    void checkBudgets();
+
+    const std::vector<Entry>& getEntries() const;
+    // Sum over an entry, or over every entry of a group
+    MemoryUsage getUsage(const std::string& name) const;
+    MemoryUsage getTotal() const;
+    // 0 when there is none
+    std::size_t getBudget(const std::string& name) const;
+
+    // Entries, group totals and budgets as JSON
+    bool save(const std::string& path) const;
+
+private:
+    struct Budget {
+        std::string name;
+        std::size_t bytes;
+        bool exceeded = false;
+    };
+
+    std::vector<Entry> entries;   // in the order they were first reported
+    std::vector<Budget> budgets;
+
+    static bool isInGroup(const std::string& entry, const std::string& group);
+};
+
+#endif // MEMORY_REGISTRY_HPP
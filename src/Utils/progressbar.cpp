@@ -1,8 +1,9 @@
 // progressbar.cpp
 #include "progressbar.hpp"
+#include <algorithm>
 
 ProgressBar::ProgressBar(sf::RenderWindow& window, const sf::Vector2f& size, const sf::Vector2f& position, const sf::Color& fillColor, const sf::Color& backgroundColor)
-    : totalItems(1), loadedItems(0), window(window)
+    : window(window)
 {
     // Set up the background bar
     backgroundBar.setSize(size);
@@ -32,43 +33,31 @@ void ProgressBar::setTotalItems(size_t total) {
 }
 
 void ProgressBar::incrementProgress() {
-    if (loadedItems < totalItems) {
-        ++loadedItems;
-        float progressRatio = static_cast<float>(loadedItems) / totalItems;
-        progressBar.setSize({backgroundBar.getSize().x * progressRatio, backgroundBar.getSize().y});
+    size_t loaded = loadedItems.load();
+    while (loaded < totalItems && !loadedItems.compare_exchange_weak(loaded, loaded + 1)) {
     }
 }
 
+void ProgressBar::setProgress(float fraction) {
+    progress = std::clamp(fraction, 0.0f, 1.0f);
+}
+
 bool ProgressBar::isComplete() const {
-    return loadedItems >= totalItems;
+    const float fraction = progress;
+    return fraction >= 0.0f ? fraction >= 1.0f : loadedItems >= totalItems;
 }
 
 void ProgressBar::draw() {
+    // Workers only touch the counters, the shapes are sized here
+    const float fraction = progress;
+    const float progressRatio = fraction >= 0.0f ? fraction : static_cast<float>(loadedItems) / totalItems;
+    progressBar.setSize({backgroundBar.getSize().x * progressRatio, backgroundBar.getSize().y});
+
     window.draw(backgroundBar);
     window.draw(progressBar);
     window.draw(loadingText);
 }
 
-
-void ProgressBar::update(const std::string& text) {
+void ProgressBar::setText(const std::string& text) {
     loadingText.setString(text);
-
-    // Display loading screen and update progress bar
-     while (window.isOpen()) {
-        sf::Event event;
-        while (window.pollEvent(event)) {
-            if (event.type == sf::Event::Closed) {
-                window.close();
-            }
-        }
-
-
-        window.clear(sf::Color::Black);
-        draw();
-        window.display();
-
-        if (isComplete()) {
-            break;
-        }
-    }
 }
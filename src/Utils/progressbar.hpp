@@ -3,6 +3,7 @@
 #define PROGRESSBAR_HPP
 
 #include <SFML/Graphics.hpp>
+#include <atomic>
 
 class ProgressBar {
 public:
@@ -11,18 +12,23 @@ public:
     // Set the total number of items to load
     void setTotalItems(size_t total);
 
-    // Update the progress by increasing the loaded items
+    // Update the progress by increasing the loaded items, safe from any thread
     void incrementProgress();
 
-    // Draw the progress bar to the window
+    // Show a fraction in [0, 1] instead of counted items, e.g. JobGraph::getProgress()
+    void setProgress(float fraction);
+
+    // Draw the progress bar to the window, from the thread that owns it
     void draw();
 
     bool isComplete() const;
 
-    void update(const std::string& text);
+    // Caption above the bar, drawing is left to the caller's frame loop
+    void setText(const std::string& text);
 private:
-    size_t totalItems = 1;
-    size_t loadedItems = 0;
+    std::atomic<size_t> totalItems{1};
+    std::atomic<size_t> loadedItems{0};
+    std::atomic<float> progress{-1.0f};   // negative while progress is counted in items
 
     sf::RectangleShape backgroundBar;
     sf::RectangleShape progressBar;
@@ -0,0 +1,193 @@
+// thread_pool.cpp
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+    std::atomic<unsigned> configuredThreadCount{0};
+
+    // Which pool the current thread works for and which queue is its own
+    thread_local const ThreadPool* currentPool = nullptr;
+    thread_local std::size_t currentQueue = 0;
+}
+
+ThreadPool::ThreadPool(unsigned threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max(2u, std::thread::hardware_concurrency()) - 1;
+    }
+    for (unsigned i = 0; i <= threadCount; i++) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for (unsigned i = 0; i < threadCount; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+ThreadPool& ThreadPool::global() {
+    static ThreadPool pool(configuredThreadCount);
+    return pool;
+}
+
+void ThreadPool::configure(unsigned threadCount) {
+    configuredThreadCount = threadCount;
+}
+
+unsigned ThreadPool::getThreadCount() const {
+    return static_cast<unsigned>(workers.size());
+}
+
+void ThreadPool::submit(Task task, TaskPriority priority) {
+    const std::size_t index = currentPool == this ? currentQueue : queues.size() - 1;
+    {
+        // Counted under the sleep lock so a worker can't miss it between checking and sleeping, and
+        // before the push so a thief can't take the task and decrement the count below zero first
+        std::lock_guard<std::mutex> sleepLock(sleepMutex);
+        std::lock_guard<std::mutex> queueLock(queues[index]->mutex);
+        ++queuedTasks;
+        queues[index]->tasks[static_cast<int>(priority)].push_back(std::move(task));
+    }
+    wake.notify_one();
+}
+
+bool ThreadPool::popTask(std::size_t self, TaskPriority lowest, Task& task) {
+    const std::size_t count = queues.size();
+    for (int priority = 0; priority <= static_cast<int>(lowest); priority++) {
+        // Newest from our own queue, its data is most likely still in cache
+        {
+            Queue& own = *queues[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks[priority].empty()) {
+                task = std::move(own.tasks[priority].back());
+                own.tasks[priority].pop_back();
+                --queuedTasks;
+                return true;
+            }
+        }
+        // Oldest from everyone else, usually the largest piece of work left
+        for (std::size_t offset = 1; offset < count; offset++) {
+            Queue& victim = *queues[(self + offset) % count];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks[priority].empty()) {
+                task = std::move(victim.tasks[priority].front());
+                victim.tasks[priority].pop_front();
+                --queuedTasks;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::runPendingTask(TaskPriority lowest) {
+    const std::size_t self = currentPool == this ? currentQueue : queues.size() - 1;
+    Task task;
+    if (!popTask(self, lowest, task)) {
+        return false;
+    }
+    task();
+    return true;
+}
+
+void ThreadPool::workerLoop(std::size_t index) {
+    currentPool = this;
+    currentQueue = index;
+
+    while (true) {
+        Task task;
+        if (popTask(index, TaskPriority::Background, task)) {
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this]() { return stopping || queuedTasks > 0; });
+        if (stopping && queuedTasks == 0) {
+            return;
+        }
+    }
+}
+
+void ThreadPool::parallelFor(std::size_t first, std::size_t last, std::size_t grain,
+    const std::function<void(std::size_t, std::size_t)>& body, TaskPriority priority) {
+    if (last <= first) {
+        return;
+    }
+    grain = std::max<std::size_t>(1, grain);
+    const std::size_t chunkCount = (last - first + grain - 1) / grain;
+
+    // Chunks are claimed rather than assigned, a busy worker just ends up taking fewer of them
+    std::atomic<std::size_t> nextChunk{0};
+    const auto claim = [&]() {
+        for (std::size_t chunk = nextChunk++; chunk < chunkCount; chunk = nextChunk++) {
+            const std::size_t begin = first + chunk * grain;
+            body(begin, std::min(last, begin + grain));
+        }
+    };
+
+    TaskGroup group(priority, *this);
+    const std::size_t helpers = std::min<std::size_t>(chunkCount - 1, workers.size());
+    for (std::size_t i = 0; i < helpers; i++) {
+        group.run(claim);
+    }
+    claim();
+    group.wait();
+}
+
+TaskGroup::TaskGroup(TaskPriority priority, ThreadPool& pool) : pool(pool), priority(priority) {}
+
+TaskGroup::~TaskGroup() {
+    waitForPending();
+}
+
+void TaskGroup::run(std::function<void()> task) {
+    ++pending;
+    pool.submit([this, task = std::move(task)]() {
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!failure) {
+                failure = std::current_exception();
+            }
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--pending == 0) {
+            done.notify_all();
+        }
+    }, priority);
+}
+
+void TaskGroup::waitForPending() {
+    while (pending > 0) {
+        if (pool.runPendingTask(priority)) {
+            continue;
+        }
+        // Nothing to help with, the rest is running elsewhere; wake up now and then in case
+        // one of those tasks queues more work
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait_for(lock, std::chrono::microseconds(500), [this]() { return pending == 0; });
+    }
+    // The last task may still be releasing the lock after dropping pending to zero
+    std::lock_guard<std::mutex> lock(mutex);
+}
+
+void TaskGroup::wait() {
+    waitForPending();
+    std::lock_guard<std::mutex> lock(mutex);
+    if (failure) {
+        std::exception_ptr error = failure;
+        failure = nullptr;
+        std::rethrow_exception(error);
+    }
+}
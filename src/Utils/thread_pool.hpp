@@ -0,0 +1,114 @@
+// thread_pool.hpp
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+enum class TaskPriority {
+    Frame,        // the current frame is waiting on it, always taken first
+    Background    // loading and generation, runs whenever no frame work is queued
+};
+
+// One set of worker threads shared by everything that wants to run in parallel, so generation,
+// parsing and meshing never oversubscribe the cores between them. Each worker has its own deque
+// per priority: tasks submitted from a worker go to its own deque and are taken back newest first,
+// idle workers steal the oldest task from the others. Tasks submitted from outside the pool go to
+// a shared queue that every worker steals from.
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    // 0 threads: one less than the hardware has, the submitting thread usually works too
+    explicit ThreadPool(unsigned threadCount = 0);
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    // Runs whatever is still queued, then joins the workers
+    ~ThreadPool();
+
+    // The pool everything shares, created on first use
+    static ThreadPool& global();
+    // Thread count for the shared pool, only has an effect before its first use
+    static void configure(unsigned threadCount);
+
+    unsigned getThreadCount() const;
+
+    // Tasks must not throw, use async or a TaskGroup to get exceptions back
+    void submit(Task task, TaskPriority priority = TaskPriority::Background);
+
+    template <typename Function>
+    auto async(Function function, TaskPriority priority = TaskPriority::Background)
+        -> std::future<std::invoke_result_t<Function>>;
+
+    // Calls body(begin, end) over [first, last) in chunks of grain items, workers claim chunks as they
+    // free up and the calling thread takes its share, returns when every chunk is done
+    void parallelFor(std::size_t first, std::size_t last, std::size_t grain,
+        const std::function<void(std::size_t, std::size_t)>& body, TaskPriority priority = TaskPriority::Frame);
+
+    // Runs one queued task on the calling thread if there is one at or above the given priority,
+    // waits use it so that a thread blocked on the pool keeps the pool moving
+    bool runPendingTask(TaskPriority lowest = TaskPriority::Background);
+
+private:
+    static constexpr int PRIORITY_COUNT = 2;
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks[PRIORITY_COUNT];
+    };
+
+    // One queue per worker, the last one is shared by threads outside the pool
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<std::size_t> queuedTasks{0};
+    bool stopping = false;
+
+    bool popTask(std::size_t self, TaskPriority lowest, Task& task);
+    void workerLoop(std::size_t index);
+};
+
+// Tasks that are waited for together, wait() rethrows the first exception any of them threw
+class TaskGroup {
+public:
+    explicit TaskGroup(TaskPriority priority = TaskPriority::Frame, ThreadPool& pool = ThreadPool::global());
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+    // Waits for the tasks still running, their exceptions are dropped
+    ~TaskGroup();
+
+    void run(std::function<void()> task);
+    // Helps with queued tasks of the group's priority or higher until every task of the group is done
+    void wait();
+
+private:
+    ThreadPool& pool;
+    TaskPriority priority;
+    std::atomic<std::size_t> pending{0};
+    std::mutex mutex;
+    std::condition_variable done;
+    std::exception_ptr failure;
+
+    void waitForPending();
+};
+
+template <typename Function>
+auto ThreadPool::async(Function function, TaskPriority priority) -> std::future<std::invoke_result_t<Function>> {
+    using Result = std::invoke_result_t<Function>;
+    auto task = std::make_shared<std::packaged_task<Result()>>(std::move(function));
+    std::future<Result> future = task->get_future();
+    submit([task]() { (*task)(); }, priority);
+    return future;
+}
+
+#endif // THREAD_POOL_HPP
@@ -1,19 +1,79 @@
 #include <SFML/Graphics.hpp>
 #include <SFML/System.hpp> // For SFML threading
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 #include <memory>
-#include <thread>
+#include <string>
+#include <tuple>
+#include <vector>
 #include "Camera/controller.hpp"
+#include "Camera/recorder.hpp"
 #include "Map/contours.hpp"
 #include "Map/renderer.hpp"
+#include "Utils/allocation_counter.hpp"
+#include "Utils/frame_arena.hpp"
+#include "Utils/job_graph.hpp"
+#include "Utils/memory_registry.hpp"
 #include "Utils/progressbar.hpp"
+#include "Utils/thread_pool.hpp"
 #include <imgui.h>
 #include <imgui-sfml.h>
 #include "Map/map_texture.hpp"
 #include "Map/gen.hpp"
+#include "Map/edge_detect.hpp"
+#include "Map/layer_compositor.hpp"
+#include "Bench/bench.hpp"
 
 #define DEBUG 1
-int main() {
+int main(int argc, char** argv) {
+    // Worker threads for the shared pool, anywhere on the command line: --threads <count>.
+    // The other options and their arguments keep their order in args
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--threads" && i + 1 < argc) {
+            ThreadPool::configure(static_cast<unsigned>(std::max(0, std::atoi(argv[++i]))));
+        } else {
+            args.emplace_back(argv[i]);
+        }
+    }
+
+    // Benchmarks run their own scene: main --bench <name>
+    if (args.size() >= 2 && args[0] == "--bench") {
+        return runBenchmark(args[1]);
+    }
+
+    // Offscreen runs for automation: main --headless [frames] [output directory] [dump every nth frame]
+    if (!args.empty() && args[0] == "--headless") {
+        HeadlessSettings settings;
+        settings.frameCount = args.size() >= 2 ? std::atoi(args[1].c_str()) : settings.frameCount;
+        settings.outputDirectory = args.size() >= 3 ? args[2] : settings.outputDirectory;
+        settings.dumpEvery = args.size() >= 4 ? std::atoi(args[3].c_str()) : settings.dumpEvery;
+        return runHeadless(settings);
+    }
+
+    // Replays a flight recorded from the debug panel: main --replay <file>
+    if (args.size() >= 2 && args[0] == "--replay") {
+        return runReplay(args[1]);
+    }
+
+    // Contours from imagery without the Python script: main --extract-contours <image> [output]
+    if (args.size() >= 2 && args[0] == "--extract-contours") {
+        const std::string output = args.size() >= 3 ? args[2] : "contours.json";
+        sf::Image image;
+        if (!image.loadFromFile(args[1])) {
+            return 1;
+        }
+        EdgeContourExtractor extractor;
+        ContourStore store;
+        if (!extractor.extract(image, store) || !store.saveToJSON(output)) {
+            return 1;
+        }
+        std::cout << "Wrote " << store.getContourCount() << " contours (" << store.getPointCount() << " points) to " << output
+                  << ", filters " << extractor.getFilterMs() << " ms, tracing " << extractor.getTraceMs() << " ms" << std::endl;
+        return 0;
+    }
+
     // Main game window setup
     sf::RenderWindow window(sf::VideoMode(1920, 1080), "Fortifier: Forge and Conquer");
     window.setFramerateLimit(144);
@@ -33,14 +93,9 @@ int main() {
 
     CameraController cameraController(view);
 
-    std::thread textureLoadingThread([&mapDrawTexture]() {
-        mapDrawTexture.loadTexturesAsync();
-    });
-
-
-    progressBar.update("Loading textures...");
+    // Returns at once, the map renders with whatever texture is uploaded so far
+    mapDrawTexture.loadTexturesAsync();
 
-    textureLoadingThread.join();
     // Main game loop
     while (window.isOpen()) {
         sf::Event event;
@@ -61,7 +116,12 @@ int main() {
         mapRenderer.draw(window);
         mapDrawTexture.draw(window);
         mapDrawTexture.updateMapTexture(cameraController.getZoomFactor(), window.getSize());
+        if (!progressBar.isComplete()) {
+            window.setView(window.getDefaultView());
+            progressBar.draw();
+        }
         window.display();
+        FrameArena::get().reset();
     }
 
 #else
@@ -73,8 +133,7 @@ int main() {
 
     srand(static_cast<unsigned>(time(0))); // Seed for random generation
     // anchor the progress bar to bottom center of the screen
-    // ProgressBar progressBar(window, sf::Vector2f(1920, 20), sf::Vector2f(0, 1080 - 20), sf::Color::Green, sf::Color::White);
-    // progressBar.setTotalItems(0);
+    ProgressBar progressBar(window, sf::Vector2f(1920, 20), sf::Vector2f(0, 1080 - 20), sf::Color::Green, sf::Color::White);
 
     sf::View view(sf::FloatRect(0, 0, 1920, 1080));
     view.setSize(1920, 1080);
@@ -82,12 +141,15 @@ int main() {
     view.zoom(1.0f);
 
     LandmassSettings landmassSettings;
-    LandmassGenerator landmassGenerator(landmassSettings);
+    std::unique_ptr<LandmassGenerator> landmassGenerator;
     CameraController cameraController(view);
-
-
-
-    // progressBar.update("Loading textures...");
+    MapRenderer mapRenderer("./countries.geo.json");
+    Contours contours("./contours.json");
+    MapDrawTexture mapDrawTexture(progressBar);
+    bool vectorTiles = false;
+    bool drawBorders = false;
+    bool drawContours = false;
+    bool drawEarth = false;
 
     sf::Clock deltaClock;
     float mapColors[3] = {0.f, 0.f, 0.f};
@@ -95,6 +157,72 @@ int main() {
     std::string countryName(100, '\0');
     RendererSettings rendererSettings = {sf::Vector2f(0.0, 0.0), sf::Vector2f(0.0, 0.0)};
 
+    // Terrain and borders are cached offscreen and only re-rendered when they change or the view leaves the cache
+    LayerCompositor compositor;
+    const std::size_t terrainLayer = compositor.addLayer([&landmassGenerator](sf::RenderTarget& target, const sf::Vector2u&) {
+        landmassGenerator->draw(target);
+    });
+    const std::size_t bordersLayer = compositor.addLayer([&](sf::RenderTarget& target, const sf::Vector2u& windowSize) {
+        mapRenderer.draw(target, 1.0f, rendererSettings, sf::Vector2u(0, 0), windowSize);
+    });
+    const auto borderState = [&]() {
+        // Everything that changes what the border layer draws
+        return std::make_tuple(mapRenderer.toggleNames, mapRenderer.cullToView, rendererSettings.scale, rendererSettings.offset,
+                               rendererSettings.fontSize, rendererSettings.fontColor[0], rendererSettings.fontColor[1],
+                               rendererSettings.fontColor[2], mapRenderer.getResidentTileCount());
+    };
+    auto previousBorderState = borderState();
+
+    // Everything loads in the background while the frame loop runs, each part is used once its job is done.
+    // Declared after what the jobs touch so it is destroyed, and its workers joined, first
+    JobGraph loader;
+    // A failed job, e.g. borders from a missing GeoJSON file, skips everything that depends on it
+    const JobGraph::JobId fontJob = loader.add("font", 1, [&mapRenderer]() {
+        // Without the font only the labels are missing, the borders still load
+        mapRenderer.loadFont();
+        return true;
+    });
+    const JobGraph::JobId geoJsonJob = loader.add("borders", 6, [&mapRenderer]() {
+        mapRenderer.loadFromGeoJSON();
+        return true;
+    }, {fontJob});
+    // Built with scripts/geo/tile.py, the resident geometry is used when it is missing
+    const JobGraph::JobId mapJob = loader.add("vector tiles", 1, [&mapRenderer, &vectorTiles]() {
+        vectorTiles = mapRenderer.setVectorTiles("res/tiles/vector");
+        return true;
+    }, {geoJsonJob});
+    const JobGraph::JobId contoursJob = loader.add("contours", 3, [&contours]() {
+        return contours.load();
+    });
+    const JobGraph::JobId terrainJob = loader.add("terrain", 2, [&landmassGenerator, initialSettings = landmassSettings]() {
+        landmassGenerator = std::make_unique<LandmassGenerator>(initialSettings);
+        return true;
+    });
+    // Decoding runs on the uploader's workers, the GL upload has to happen here
+    const JobGraph::JobId texturesJob = loader.addMainThread("textures", 4, [&, started = false]() mutable {
+        if (!started) {
+            mapDrawTexture.loadTexturesAsync();
+            started = true;
+        }
+        mapDrawTexture.updateMapTexture(cameraController.getZoomFactor(), window.getSize());
+        return mapDrawTexture.isLoaded();
+    });
+    loader.start();
+
+    // Camera input and setting changes, saved to flight.rec for `main --replay`
+    CameraRecording flightRecording;
+    std::vector<std::pair<std::string, float>> recordedSettings;
+
+    // Heap allocations made while drawing the map, a steady frame should make none
+    AllocationCounter renderAllocations;
+    std::uint64_t lastRenderAllocations = 0;
+
+    // Memory by subsystem, refreshed twice a second. memory_budgets.json maps group or entry
+    // names to megabytes, e.g. {"terrain": 64, "textures.tiles": 256}
+    MemoryRegistry memoryRegistry;
+    memoryRegistry.loadBudgets("memory_budgets.json");
+    sf::Clock memoryClock;
+
     while (window.isOpen()) {
         sf::Event event;
         while (window.pollEvent(event)) {
@@ -103,13 +231,50 @@ int main() {
                 window.close();
                 ImGui::SFML::Shutdown(window);
             }
+            if (event.type == sf::Event::MouseWheelScrolled) {
+                flightRecording.recordScroll(event.mouseWheelScroll.delta);
+            }
             cameraController.handleEvent(event);
         }
         ImGui::SFML::Update(window, deltaClock.restart());
+        loader.poll();
+        const bool terrainLoaded = loader.isDone(terrainJob);
+        const bool mapLoaded = loader.isDone(mapJob);
+        if (memoryClock.getElapsedTime() >= sf::milliseconds(500)) {
+            memoryClock.restart();
+            // Only what is loaded, the loader jobs are still writing the rest
+            if (terrainLoaded) {
+                landmassGenerator->reportMemory(memoryRegistry);
+            }
+            if (mapLoaded) {
+                mapRenderer.reportMemory(memoryRegistry);
+            }
+            if (loader.isDone(contoursJob)) {
+                contours.reportMemory(memoryRegistry, "contours");
+            }
+            mapDrawTexture.reportMemory(memoryRegistry);
+            memoryRegistry.checkBudgets();
+        }
 
         ImGui::Begin("Debug");
         ImGui::Text("FPS: %lf", ImGui::GetIO().Framerate);
         ImGui::Text("Zoom: %lf", cameraController.getZoomFactor());
+        ImGui::Text("Layers re-rendered: %zu", compositor.getRenderCount());
+        ImGui::Text("Render heap allocations: %llu", static_cast<unsigned long long>(lastRenderAllocations));
+        ImGui::Text("Frame arena: %.1f KB peak of %.1f KB", FrameArena::get().getPeak() / 1024.0, FrameArena::get().getCapacity() / 1024.0);
+        if (ImGui::Button(flightRecording.isRecording() ? "Stop Recording" : "Record Flight")) {
+            if (flightRecording.isRecording()) {
+                flightRecording.end();
+                flightRecording.save("flight.rec");
+            } else {
+                recordedSettings.clear();
+                flightRecording.begin(view, cameraController.getZoomFactor());
+            }
+        }
+        if (flightRecording.isRecording()) {
+            ImGui::SameLine();
+            ImGui::Text("%u frames", flightRecording.getFrameCount());
+        }
         ImGui::Text("Mouse Position: %lf, %lf", ImGui::GetIO().MousePos.x, ImGui::GetIO().MousePos.y);
         ImGui::ColorEdit3("Color", mapColors);
         ImGui::ColorEdit3("Contour Color", contourColor);
@@ -118,29 +283,119 @@ int main() {
             ImGui::SliderFloat("Octave Multiplier Y", &landmassSettings.octaveMultiplierY, 0.01, 1.0, "%.2f");
             ImGui::SliderInt("Octaves", &landmassSettings.octaves, 1, 20);
             ImGui::SliderInt("Seed", &landmassSettings.seedValue, 1, 1000000);
+            ImGui::SliderFloat("Warp Strength", &landmassSettings.warpStrength, 0.0, 4.0, "%.2f");
+            ImGui::SliderInt("Warp Octaves", &landmassSettings.warpOctaves, 1, 8);
             ImGui::SliderFloat("Water Threshold", &landmassSettings.waterThreshold, 0.0, 1.0, "%.2f");
             ImGui::SliderFloat("Plains Threshold", &landmassSettings.plainsThreshold, 0.0, 1.0, "%.2f");
             ImGui::SliderFloat("Hills Threshold", &landmassSettings.hillsThreshold, 0.0, 1.0, "%.2f");
             ImGui::SliderFloat("Cube Height Multiplier", &landmassSettings.cubeHeightMultiplier, 0.0, 1000.0, "%.2f");
             ImGui::Checkbox("Draw Grid", &landmassSettings.drawGrid);
             ImGui::Checkbox("Draw Cubes", &landmassSettings.drawCubes);
+            ImGui::Checkbox("Instanced Cubes", &landmassSettings.instancedCubes);
+            ImGui::Checkbox("Biomes", &landmassSettings.drawBiomes);
+            ImGui::Checkbox("Draw Isolines", &landmassSettings.drawIsolines);
+            if (landmassSettings.drawIsolines && terrainLoaded) {
+                ImGui::Text("Isolines: %zu lines in %.2f ms", landmassGenerator->getIsolineCount(), landmassGenerator->getIsolineBuildMs());
+            }
+        }
+        if(ImGui::CollapsingHeader("Map Settings")) {
+            ImGui::Checkbox("Draw Borders", &drawBorders);
+            ImGui::Checkbox("Show Names", &mapRenderer.toggleNames);
+            ImGui::Checkbox("Cull To View", &mapRenderer.cullToView);
+            ImGui::SliderFloat("Font Size", &rendererSettings.fontSize, 1.0, 50.0, "%.1f");
+            ImGui::ColorEdit3("Font Color", rendererSettings.fontColor);
+            ImGui::Checkbox("Draw Contours", &drawContours);
+            ImGui::Checkbox("Draw Earth Texture", &drawEarth);
+        }
+        if (mapLoaded && ImGui::CollapsingHeader("Map Statistics")) {
+            ImGui::Text("Visible Polygons: %zu / %zu", mapRenderer.getVisiblePolygonCount(), mapRenderer.getPolygonCount());
+            ImGui::Text("Visible Labels: %zu", mapRenderer.getVisibleLabelCount());
+            ImGui::Text("Geometry: %.1f KB for %zu points", mapRenderer.getGeometryMemoryUsage() / 1024.0, mapRenderer.getPointCount());
+            if (vectorTiles) {
+                ImGui::Text("Vector Tiles: %zu resident, %zu loading", mapRenderer.getResidentTileCount(), mapRenderer.getPendingTileCount());
+            }
+        }
+        if (ImGui::CollapsingHeader("Memory")) {
+            const MemoryUsage total = memoryRegistry.getTotal();
+            ImGui::Text("Total: %.2f MB in %zu allocations", total.bytes / (1024.0 * 1024.0), total.allocations);
+            for (const auto& entry : memoryRegistry.getEntries()) {
+                ImGui::Text("%s: %.2f MB in %zu allocations", entry.name.c_str(), entry.usage.bytes / (1024.0 * 1024.0), entry.usage.allocations);
+            }
+            if (ImGui::Button("Dump Memory")) {
+                memoryRegistry.save("memory.json");
+            }
         }
         ImGui::End();
         window.setView(view);
         // Obtain map scaling and offset
         sf::Vector2u windowSize = window.getSize();
         window.clear(sf::Color::Black);
-        landmassGenerator.settings = landmassSettings;
         sf::Color updatedContourColor(static_cast<sf::Uint8>(contourColor[0] * 255),
                                   static_cast<sf::Uint8>(contourColor[1] * 255),
                                       static_cast<sf::Uint8>(contourColor[2] * 255));
+        if (terrainLoaded) {
+            landmassGenerator->settings = landmassSettings;
+            landmassGenerator->setIsolineColor(updatedContourColor);
+        }
         float mapScale = cameraController.getZoomFactor();
         sf::Vector2f mapOffset = cameraController.getOffsetWithZoom();
-        cameraController.update();
+        const sf::Vector2f panDirection = CameraController::readKeyboardPan();
+        flightRecording.recordPan(panDirection);
+        cameraController.update(panDirection);
+        if (flightRecording.isRecording()) {
+            std::vector<std::pair<std::string, float>> settingValues = getLandmassSettingValues(landmassSettings);
+            settingValues.emplace_back("drawBorders", drawBorders ? 1.0f : 0.0f);
+            settingValues.emplace_back("showNames", mapRenderer.toggleNames ? 1.0f : 0.0f);
+            // Drawn colours and label size, the layer caches are re-rendered when they change
+            settingValues.emplace_back("fontSize", rendererSettings.fontSize);
+            for (int channel = 0; channel < 3; channel++) {
+                const std::string suffix = std::string(1, "RGB"[channel]);
+                settingValues.emplace_back("fontColor" + suffix, rendererSettings.fontColor[channel]);
+                settingValues.emplace_back("mapColor" + suffix, mapColors[channel]);
+                settingValues.emplace_back("contourColor" + suffix, contourColor[channel]);
+            }
+            for (std::size_t i = 0; i < settingValues.size(); i++) {
+                if (recordedSettings.size() != settingValues.size() || recordedSettings[i] != settingValues[i]) {
+                    flightRecording.recordSetting(settingValues[i].first, settingValues[i].second);
+                }
+            }
+            recordedSettings = settingValues;
+        }
         // Render main game window
-        landmassGenerator.draw(window);
+        renderAllocations.reset();
+        if (terrainLoaded && landmassGenerator->update()) {
+            compositor.markDirty(terrainLayer);
+        }
+        // Borders also follow the label settings and the vector tiles as they stream in
+        if (mapLoaded) {
+            const auto currentBorderState = borderState();
+            if (currentBorderState != previousBorderState || mapRenderer.getPendingTileCount() > 0) {
+                previousBorderState = currentBorderState;
+                compositor.markDirty(bordersLayer);
+            }
+        }
+        if (drawEarth && loader.isDone(texturesJob)) {
+            mapDrawTexture.updateMapTexture(cameraController.getZoomFactor(), windowSize);
+            mapDrawTexture.draw(window);
+        }
+        compositor.setVisible(terrainLayer, terrainLoaded);
+        compositor.setVisible(bordersLayer, drawBorders && mapLoaded);
+        compositor.draw(window);
+        if (drawContours && loader.isDone(contoursJob)) {
+            contours.draw(window, 1.0f);
+        }
+        lastRenderAllocations = renderAllocations.getCount();
+        if (!loader.isComplete()) {
+            progressBar.setProgress(loader.getProgress());
+            progressBar.setText("Loading " + loader.getStatus());
+            window.setView(window.getDefaultView());
+            progressBar.draw();
+            window.setView(view);
+        }
         ImGui::SFML::Render(window);
         window.display();
+        FrameArena::get().reset();
+        flightRecording.nextFrame();
     }
     ImGui::SFML::Shutdown(window);
 